@@ -0,0 +1,282 @@
+// Standalone benchmark for GSX's control-rate parameter path.
+//
+// Times, per engine sample, the work that turns knobs and CVs into grain
+// parameters: the per-sample readParams() loop GSX used before the Control
+// rate option, against advanceControls() at each of the menu's intervals.
+// Grain rendering is the same in every case and is left out. Param, Input
+// and the parameter reads are trimmed copies of those in src/gsx.cpp; keep
+// them in step when that code changes.
+//
+// Not part of the plugin build. From the repository root:
+//   g++ -O2 -std=c++11 -o /tmp/gsx-control-rate bench/gsx-control-rate.cpp
+//   /tmp/gsx-control-rate
+//
+// Prints ns per sample, best of 7 interleaved runs, for 1 and 16 channels with no CV
+// patched and with every CV patched.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+static const int MAX_CHANNELS = 16;
+static const float SAMPLE_TIME = 1.f / 48000.f;
+static const int RUN_SAMPLES = 48000 * 5;
+static const int RUNS = 7;
+
+static float clamp(float x, float a, float b) {
+	return std::min(std::max(x, a), b);
+}
+
+static int clamp(int x, int a, int b) {
+	return std::min(std::max(x, a), b);
+}
+
+struct Param {
+	float value = 0.f;
+	float getValue() const {
+		return value;
+	}
+};
+
+struct Input {
+	float voltages[MAX_CHANNELS] = {};
+	bool connected = false;
+	bool isConnected() const {
+		return connected;
+	}
+	float getPolyVoltage(int c) const {
+		return voltages[c];
+	}
+};
+
+struct GrainParams {
+	float centerFreq = 130.81f;
+	int numStreams = 10;
+	float shape = 0.f;
+	float range = 100.f;
+	float duration = 0.02f;
+	float delay = 0.01f;
+	float variation = 0.5f;
+	float spread = 0.5f;
+	float vcaGain = 1.f;
+	double liveNow = 0.0;
+	float frameTime = SAMPLE_TIME;
+};
+
+enum ParamId {
+	FREQUENCY,
+	STREAMS,
+	SHAPE,
+	RANGE,
+	DURATION,
+	DELAY,
+	DENSITY,
+	VARIATION,
+	SPREAD,
+	VCA,          // input only
+	NUM_CONTROLS
+};
+
+struct ControlPath {
+	static constexpr float CONTROL_SMOOTH_TIME = 0.002f;
+	static constexpr int MAX_CONTROL_INTERVAL = 64;
+
+	Param params[NUM_CONTROLS];
+	Input inputs[NUM_CONTROLS];
+	int controlInterval = 1;
+	int controlCounter = 0;
+	int controlChannels = 0;
+	GrainParams controlParams[MAX_CHANNELS];
+	float vcaStep[MAX_CHANNELS] = {};
+	long liveFrames = 0;
+
+	// Out of line, so every path calls the same code. Left to itself gcc
+	// inlines it into whichever call site it likes, and the table then
+	// measures that choice rather than the paths.
+	__attribute__((noinline)) void readParams(GrainParams& p, int c) {
+		float centerFreq = std::pow(2.f, params[FREQUENCY].getValue());
+		if (inputs[FREQUENCY].isConnected()) {
+			centerFreq *= std::pow(2.f, inputs[FREQUENCY].getPolyVoltage(c));
+		}
+		p.centerFreq = clamp(centerFreq, 50.f, 2000.f);
+
+		int numStreams = (int)std::round(params[STREAMS].getValue());
+		if (inputs[STREAMS].isConnected()) {
+			numStreams = (int)std::round(clamp(params[STREAMS].getValue() +
+				inputs[STREAMS].getPolyVoltage(c) * 2.f, 1.f, 20.f));
+		}
+		p.numStreams = clamp(numStreams, 1, 20);
+
+		float shape = params[SHAPE].getValue();
+		if (inputs[SHAPE].isConnected()) {
+			shape = clamp(shape + inputs[SHAPE].getPolyVoltage(c) / 5.f, 0.f, 1.f);
+		}
+		p.shape = shape;
+
+		float range = params[RANGE].getValue();
+		if (inputs[RANGE].isConnected()) {
+			range = clamp(range + inputs[RANGE].getPolyVoltage(c) * 100.f, 0.f, 500.f);
+		}
+		p.range = range;
+
+		float duration = params[DURATION].getValue() / 1000.f;
+		if (inputs[DURATION].isConnected()) {
+			duration = clamp((params[DURATION].getValue() +
+				inputs[DURATION].getPolyVoltage(c) * 20.f) / 1000.f, 0.001f, 0.1f);
+		}
+		p.duration = duration;
+
+		float density = params[DENSITY].getValue();
+		if (inputs[DENSITY].isConnected()) {
+			density = clamp(params[DENSITY].getValue() +
+				inputs[DENSITY].getPolyVoltage(c) * 200.f, 1.f, 1000.f);
+		}
+		float delay = 1.f / density;
+		float delayOffset = params[DELAY].getValue() / 1000.f;
+		if (inputs[DELAY].isConnected()) {
+			delayOffset = clamp((params[DELAY].getValue() +
+				inputs[DELAY].getPolyVoltage(c) * 40.f) / 1000.f, 0.0001f, 0.2f);
+		}
+		if (delayOffset > 0.0002f) {
+			delay = delayOffset;
+		}
+		p.delay = delay;
+
+		float variation = params[VARIATION].getValue();
+		if (inputs[VARIATION].isConnected()) {
+			variation = clamp(variation + inputs[VARIATION].getPolyVoltage(c) / 5.f, 0.f, 1.f);
+		}
+		p.variation = variation;
+
+		float spread = params[SPREAD].getValue();
+		if (inputs[SPREAD].isConnected()) {
+			spread = clamp(spread + inputs[SPREAD].getPolyVoltage(c) / 5.f, 0.f, 1.f);
+		}
+		p.spread = spread;
+
+		float vcaGain = 1.f;
+		if (inputs[VCA].isConnected()) {
+			vcaGain = clamp(inputs[VCA].getPolyVoltage(c) / 5.f, 0.f, 1.f);
+		}
+		p.vcaGain = vcaGain;
+
+		p.liveNow = (double)liveFrames - 1.0;
+		p.frameTime = SAMPLE_TIME;
+	}
+
+	// GSX before the Control rate option
+	void readEverySample(int channels) {
+		for (int c = 0; c < channels; c++) {
+			readParams(controlParams[c], c);
+		}
+	}
+
+	void updateControls(int channels, float sampleTime) {
+		bool snap = (channels != controlChannels);
+		float a = snap ? 1.f : 1.f - std::exp(-controlInterval * sampleTime / CONTROL_SMOOTH_TIME);
+		for (int c = 0; c < channels; c++) {
+			if (snap) {
+				readParams(controlParams[c], c);
+				vcaStep[c] = 0.f;
+				continue;
+			}
+			GrainParams target;
+			readParams(target, c);
+			GrainParams& p = controlParams[c];
+			p.centerFreq = target.centerFreq;
+			p.shape += a * (target.shape - p.shape);
+			p.range += a * (target.range - p.range);
+			p.duration += a * (target.duration - p.duration);
+			p.delay += a * (target.delay - p.delay);
+			p.variation += a * (target.variation - p.variation);
+			p.spread += a * (target.spread - p.spread);
+			p.numStreams = target.numStreams;
+			p.frameTime = target.frameTime;
+			vcaStep[c] = (target.vcaGain - p.vcaGain) / controlInterval;
+		}
+		controlChannels = channels;
+	}
+
+	void advanceControls(int channels, float sampleTime) {
+		if (controlInterval == 1) {
+			for (int c = 0; c < channels; c++) {
+				readParams(controlParams[c], c);
+			}
+			controlChannels = channels;
+			// A switch to a longer interval reads again on its first sample
+			controlCounter = MAX_CONTROL_INTERVAL;
+			return;
+		}
+		if (channels != controlChannels || ++controlCounter >= controlInterval) {
+			controlCounter = 0;
+			updateControls(channels, sampleTime);
+		}
+		else {
+			for (int c = 0; c < channels; c++) {
+				controlParams[c].vcaGain += vcaStep[c];
+			}
+		}
+		double liveNow = (double)liveFrames - 1.0;
+		for (int c = 0; c < channels; c++) {
+			controlParams[c].liveNow = liveNow;
+		}
+	}
+};
+
+// One run; interval 0 = the old per-sample path
+static double measure(int channels, bool cvs, int interval) {
+	volatile float sink = 0.f;
+	ControlPath path;
+	for (int i = 0; i < NUM_CONTROLS; i++) {
+		path.params[i].value = 0.3f + i;
+		path.inputs[i].connected = cvs;
+		for (int c = 0; c < MAX_CHANNELS; c++) path.inputs[i].voltages[c] = 0.1f * c;
+	}
+	path.params[DENSITY].value = 50.f;
+	path.controlInterval = std::max(interval, 1);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int n = 0; n < RUN_SAMPLES; n++) {
+		path.liveFrames++;
+		// A moving pitch CV, so nothing can be hoisted out of the loop
+		path.inputs[FREQUENCY].voltages[0] = (n & 1023) * 1e-3f;
+		if (interval == 0)
+			path.readEverySample(channels);
+		else
+			path.advanceControls(channels, SAMPLE_TIME);
+		sink = sink + path.controlParams[0].centerFreq;
+	}
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / RUN_SAMPLES;
+}
+
+int main() {
+	const int channelCounts[] = {1, 16};
+	const int intervals[] = {0, 1, 8, 32, 64};
+	double best[2][2][5];
+	for (int i = 0; i < 2 * 2 * 5; i++) (&best[0][0][0])[i] = 1e30;
+
+	// Runs are interleaved so a busy moment on the machine doesn't land on
+	// one configuration only
+	for (int run = 0; run < RUNS; run++) {
+		for (int ch = 0; ch < 2; ch++) {
+			for (int cv = 0; cv < 2; cv++) {
+				for (int i = 0; i < 5; i++) {
+					double t = measure(channelCounts[ch], cv, intervals[i]);
+					best[ch][cv][i] = std::min(best[ch][cv][i], t);
+				}
+			}
+		}
+	}
+
+	std::printf("ns per sample    before      @1      @8     @32     @64\n");
+	for (int ch = 0; ch < 2; ch++) {
+		for (int cv = 0; cv < 2; cv++) {
+			std::printf("%2d ch, CVs %-4s", channelCounts[ch], cv ? "all" : "none");
+			for (int i = 0; i < 5; i++) std::printf("  %6.1f", best[ch][cv][i]);
+			std::printf("\n");
+		}
+	}
+	return 0;
+}
@@ -1,9 +1,139 @@
 #include "plugin.hpp"
+#include "clock-arbiter.hpp"
 #include <cmath>
 
 
 static const int NUM_PATTERNS = 8;
 static const int MAX_STEPS = 16;
+static const int MAX_LANES = 16;
+
+
+// --- Step masks ---
+// Steps and accents are 16-bit masks, bit i = step i. Transforms work on
+// whole masks at once, limited to the pattern's length.
+
+static inline uint16_t lengthMask(int length) {
+	return (uint16_t)((1u << length) - 1u);
+}
+
+static inline uint16_t rotateMask(uint16_t m, int n, int length) {
+	n = ((n % length) + length) % length;
+	if (n == 0) return m;
+	m &= lengthMask(length);
+	return (uint16_t)(((m << n) | (m >> (length - n))) & lengthMask(length));
+}
+
+static inline uint16_t reverseMask(uint16_t m, int length) {
+	uint32_t r = m;
+	r = ((r & 0x5555u) << 1) | ((r >> 1) & 0x5555u);
+	r = ((r & 0x3333u) << 2) | ((r >> 2) & 0x3333u);
+	r = ((r & 0x0F0Fu) << 4) | ((r >> 4) & 0x0F0Fu);
+	r = ((r & 0x00FFu) << 8) | ((r >> 8) & 0x00FFu);
+	return (uint16_t)(r >> (MAX_STEPS - length));
+}
+
+static inline int countSteps(uint16_t m) {
+	int n = 0;
+	for (; m; m &= (uint16_t)(m - 1)) n++;
+	return n;
+}
+
+// Euclidean rhythms for every hits/length pair, built once: hits spread as
+// evenly as they go over the length, with a hit on step 0
+static uint16_t euclideanMask(int hits, int length) {
+	struct Table {
+		uint16_t masks[MAX_STEPS + 1][MAX_STEPS + 1];
+		Table() {
+			for (int len = 0; len <= MAX_STEPS; len++) {
+				for (int k = 0; k <= MAX_STEPS; k++) {
+					uint16_t m = 0;
+					for (int i = 0; i < len; i++) {
+						if ((i * k) % len < k) m |= (uint16_t)(1u << i);
+					}
+					masks[len][k] = m;
+				}
+			}
+		}
+	};
+	static const Table table;
+	return table.masks[length][clamp(hits, 0, length)];
+}
+
+
+// --- Step event queue ---
+// Hits waiting for their time, earliest first. A fixed-size binary heap, so
+// the audio thread never allocates, and a sample with nothing due costs one
+// comparison against the top.
+
+struct StepEvent {
+	double time;       // on the ClockArbiter's sample clock
+	float velocity;
+	float spacing;     // samples to the next hit of a ratchet, 0 = single hit
+	uint8_t lane;
+	bool accent;
+	bool early;        // queued a clock ahead of its step
+};
+
+struct StepEventQueue {
+	// Three steps of 8x ratchets on 16 lanes: a late hit's ratchets can run
+	// about 1.4 clocks, so they may still be pending as the next two steps queue
+	static const int CAPACITY = 3 * 8 * MAX_LANES;
+	StepEvent events[CAPACITY];
+	int size = 0;
+
+	void clear() {
+		size = 0;
+	}
+
+	bool due(double now) const {
+		return size > 0 && events[0].time <= now;
+	}
+
+	// Returns false, dropping the hit, when full
+	bool push(const StepEvent& e) {
+		if (size >= CAPACITY) return false;
+		int i = size++;
+		while (i > 0) {
+			int parent = (i - 1) / 2;
+			if (events[parent].time <= e.time) break;
+			events[i] = events[parent];
+			i = parent;
+		}
+		events[i] = e;
+		return true;
+	}
+
+	StepEvent pop() {
+		StepEvent top = events[0];
+		StepEvent last = events[--size];
+		if (size > 0) siftDown(0, last);
+		return top;
+	}
+
+	// Drop the hits of a step queued a clock ahead, for when a BAR cuts the
+	// pattern short and that step never comes
+	void dropEarly() {
+		int kept = 0;
+		for (int i = 0; i < size; i++) {
+			if (!events[i].early) events[kept++] = events[i];
+		}
+		size = kept;
+		for (int i = size / 2 - 1; i >= 0; i--) siftDown(i, events[i]);
+	}
+
+	// Place `e` at slot i or below, moving earlier children up
+	void siftDown(int i, StepEvent e) {
+		while (true) {
+			int child = 2 * i + 1;
+			if (child >= size) break;
+			if (child + 1 < size && events[child + 1].time < events[child].time) child++;
+			if (e.time <= events[child].time) break;
+			events[i] = events[child];
+			i = child;
+		}
+		events[i] = e;
+	}
+};
 
 
 // Forward declaration
@@ -15,7 +145,7 @@ struct BeatDisplay : OpaqueWidget {
 	std::shared_ptr<Font> font;
 
 	// Cached layout rects (in widget-local pixel coords). Recomputed each draw.
-	rack::math::Rect tabRect[4];          // STEPS / VEL / ACC / PROB
+	rack::math::Rect tabRect[6];          // STEPS / VEL / ACC / PROB / TIME / RAT
 	rack::math::Rect stepGridRect;
 	rack::math::Rect lengthDotRect[MAX_STEPS];  // 16 small dots
 	rack::math::Rect repeatsRect[8];      // 8 cells: 1..MAX_REPEATS
@@ -35,7 +165,7 @@ struct BeatDisplay : OpaqueWidget {
 	bool paintState = false;        // For STEP/ACC paint
 	int dragStep = -1;              // For VEL mode: which step is being dragged
 	float dragStartY = 0.f;
-	float dragStartVel = 0.f;
+	float dragStartVel = 0.f;       // value being dragged, 0..1, unclamped steps accumulate here
 	rack::math::Vec dragPos;        // Tracked widget-local cursor during drag
 
 	void computeLayout();
@@ -61,11 +191,18 @@ struct BeatDisplay : OpaqueWidget {
 
 
 struct Beat : Module {
-	enum ParamId { PARAMS_LEN };
+	enum ParamId {
+		// Per-lane swing, set from the context menu
+		SWING_PARAM_0,
+		PARAMS_LEN = SWING_PARAM_0 + MAX_LANES
+	};
 	enum InputId {
 		CLOCK_INPUT,
 		BAR_INPUT,
 		RESET_INPUT,
+		XFORM_INPUT,
+		XFORM_CV_INPUT,
+		MORPH_INPUT,
 		INPUTS_LEN
 	};
 	enum OutputId {
@@ -81,27 +218,104 @@ struct Beat : Module {
 		MODE_VEL,
 		MODE_ACC,
 		MODE_PROB,
+		MODE_TIME,
+		MODE_RAT,
 		NUM_MODES
 	};
 
 	static const int MAX_REPEATS = 8;
+	static const int MAX_RATCHETS = 8;
+
+	// Pattern transforms, in the order the XFORM CV selects them (1V apart)
+	enum Transform {
+		XFORM_ROTATE_RIGHT = 0,
+		XFORM_ROTATE_LEFT,
+		XFORM_INVERT,
+		XFORM_REVERSE,
+		XFORM_EUCLID,
+		XFORM_AND,
+		XFORM_OR,
+		XFORM_XOR,
+		NUM_TRANSFORMS
+	};
 
-	struct Pattern {
-		bool steps[MAX_STEPS];
+	// One voice's steps within a pattern. Lanes of a pattern share its
+	// length, repeats and the playhead; lane 0 is the only one in use unless
+	// the module is set to more lanes.
+	struct Lane {
+		uint16_t steps;    // bit i = step i on
+		uint16_t accents;  // bit i = step i accented
 		float velocities[MAX_STEPS];
-		bool accents[MAX_STEPS];
 		float probabilities[MAX_STEPS];   // 0..1, chance the step actually fires
-		int length;
-		int repeats;       // Number of bars to play before advancing (1-8)
-		bool active;
+		float nudges[MAX_STEPS];          // -0.5..0.5 of a step, negative = early
+		uint8_t ratchets[MAX_STEPS];      // hits per step, 1..MAX_RATCHETS
 
-		Pattern() {
+		Lane() {
+			clear();
+		}
+
+		void clear() {
+			steps = 0;
+			accents = 0;
 			for (int i = 0; i < MAX_STEPS; i++) {
-				steps[i] = false;
 				velocities[i] = 1.f;
-				accents[i] = false;
 				probabilities[i] = 1.f;
+				nudges[i] = 0.f;
+				ratchets[i] = 1;
 			}
+		}
+
+		bool stepOn(int i) const { return (steps >> i) & 1; }
+		bool accentOn(int i) const { return (accents >> i) & 1; }
+		void setStep(int i, bool on) {
+			if (on) steps |= (uint16_t)(1u << i);
+			else steps &= (uint16_t)~(1u << i);
+		}
+		void setAccent(int i, bool on) {
+			if (on) accents |= (uint16_t)(1u << i);
+			else accents &= (uint16_t)~(1u << i);
+		}
+
+		// Transforms rewrite the masks within `length`; steps past it are
+		// left alone. Velocity, probability, nudge and ratchets stay with
+		// their step positions. `other` is only read by the logic transforms.
+		void transform(int op, const Lane& other, int length) {
+			uint16_t inLen = lengthMask(length);
+			uint16_t keep = (uint16_t)~inLen;
+			uint16_t s = steps & inLen;
+			uint16_t a = accents & inLen;
+			switch (op) {
+				case XFORM_ROTATE_RIGHT:
+					s = rotateMask(s, 1, length);
+					a = rotateMask(a, 1, length);
+					break;
+				case XFORM_ROTATE_LEFT:
+					s = rotateMask(s, -1, length);
+					a = rotateMask(a, -1, length);
+					break;
+				case XFORM_INVERT: s = (uint16_t)(~s & inLen); break;
+				case XFORM_REVERSE:
+					s = reverseMask(s, length);
+					a = reverseMask(a, length);
+					break;
+				case XFORM_EUCLID: s = euclideanMask(countSteps(s), length); break;
+				case XFORM_AND: s &= other.steps; break;
+				case XFORM_OR: s = (uint16_t)((s | other.steps) & inLen); break;
+				case XFORM_XOR: s = (uint16_t)((s ^ other.steps) & inLen); break;
+				default: break;
+			}
+			steps = (uint16_t)((steps & keep) | s);
+			accents = (uint16_t)((accents & keep) | a);
+		}
+	};
+
+	struct Pattern {
+		Lane lanes[MAX_LANES];   // contiguous, so a clock edge walks them in one pass
+		int length;
+		int repeats;       // Number of bars to play before advancing (1-8)
+		bool active;
+
+		Pattern() {
 			length = 16;
 			repeats = 1;
 			active = false;
@@ -114,7 +328,9 @@ struct Beat : Module {
 	int playStep = 0;
 	int editMode = MODE_STEPS;
 	int currentBar = 1;          // Which bar of the loop we are in (1..reps)
-	float currentVelocity = 1.f;
+	int numLanes = 1;            // 1 = mono outputs as always; more = poly, a channel per lane
+	int editLane = 0;
+	float currentVelocity[MAX_LANES];
 
 	// True between Reset (or fresh start) and the next BAR-aligned downbeat.
 	// Makes the first audible step 0 land on a real downbeat:
@@ -133,37 +349,58 @@ struct Beat : Module {
 	// behavior). When false, pattern wrap also advances when BAR isn't patched.
 	bool advanceOnBarOnly = true;
 
-	dsp::SchmittTrigger clockTrigger;
-	dsp::SchmittTrigger barTrigger;
 	dsp::SchmittTrigger resetTrigger;
-	dsp::PulseGenerator gatePulse;
-	dsp::PulseGenerator accentPulse;
-
-	// Bar/clock coincidence handling. CLOCK and BAR from Meter SHOULD arrive
-	// on the same sample, but in practice can be off by a few samples. Two
-	// guards keep step 0 from double-firing on bar boundaries:
-	//   - pendingClockSamples: defer a CLOCK fire by N samples; if a BAR
-	//     arrives within that window, it cancels the pending clock (so the
-	//     BAR's advanceBar handles step 0 alone).
-	//   - barSuppressionSamples: after a BAR fires, drop any CLOCK that
-	//     arrives within the window (it's the same musical event).
-	int pendingClockSamples = -1;
-	int barSuppressionSamples = 0;
-	static const int CLOCK_DEFER_SAMPLES = 24;    // ~0.5ms at 48kHz
-	static const int BAR_SUPPRESS_SAMPLES = 96;   // ~2ms at 48kHz
+	dsp::SchmittTrigger xformTrigger;
+	int transformOp = XFORM_ROTATE_RIGHT;   // XFORM CV adds to this
+	dsp::PulseGenerator gatePulse[MAX_LANES];
+	dsp::PulseGenerator accentPulse[MAX_LANES];
+
+	// Bar/clock coincidence handling: keeps step 0 from double-firing when
+	// CLOCK and BAR arrive a little apart (see clock-arbiter.hpp)
+	ClockArbiter arbiter;
+
+	// Hits go out through the queue at their own times rather than on the
+	// clock edge, for nudges, ratchets and swing (see scheduleStep)
+	StepEventQueue eventQueue;
+	int earlyStep[MAX_LANES];   // step queued a clock ahead, -1 = none
+
+	// MORPH blends the playing pattern toward the next active one. The blend
+	// is worked out ahead into a set of lanes that playback reads in place of
+	// the pattern's, so a clock costs the same either way. It's refreshed at
+	// control rate (picking up the CV and any edits) and at once when the
+	// pair of patterns changes.
+	Lane morphLanes[MAX_LANES];
+	int morphFrom = -1;
+	int morphTo = -1;
+	float morphAmount = 0.f;
+	dsp::ClockDivider morphDivider;
 
 	Beat() {
 		config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
 		configInput(CLOCK_INPUT, "Clock (step advance)");
 		configInput(BAR_INPUT, "Bar (pattern advance)");
 		configInput(RESET_INPUT, "Reset");
+		configInput(XFORM_INPUT, "Transform playing pattern");
+		configInput(XFORM_CV_INPUT, "Transform select (1V per transform)");
+		configInput(MORPH_INPUT, "Morph toward next pattern (0-10V)");
+		// Polyphonic, one channel per lane, when there's more than one lane
 		configOutput(GATE_OUTPUT, "Gate");
 		configOutput(VELOCITY_OUTPUT, "Velocity (0-10V)");
 		configOutput(ACCENT_OUTPUT, "Accent");
+		for (int l = 0; l < MAX_LANES; l++) {
+			configParam(SWING_PARAM_0 + l, 0.f, 1.f, 0.f, string::f("Lane %d swing", l + 1), "%", 0.f, 100.f);
+			// Menu-only timing; Randomize leaves it alone as it always did
+			paramQuantities[SWING_PARAM_0 + l]->randomizeEnabled = false;
+		}
 		// Default: all patterns active. An "active empty" pattern is the
 		// silent option; right-click a cell to skip it from the rotation.
 		for (int p = 0; p < NUM_PATTERNS; p++) patterns[p].active = true;
 		currentBar = 1;
+		for (int l = 0; l < MAX_LANES; l++) {
+			currentVelocity[l] = 1.f;
+			earlyStep[l] = -1;
+		}
+		morphDivider.setDivision(256);
 	}
 
 	void onReset() override {
@@ -176,8 +413,14 @@ struct Beat : Module {
 		playStep = 0;
 		editMode = MODE_STEPS;
 		currentBar = 1;
-		currentVelocity = 1.f;
+		numLanes = 1;
+		editLane = 0;
+		for (int l = 0; l < MAX_LANES; l++) currentVelocity[l] = 1.f;
 		advanceOnBarOnly = true;
+		transformOp = XFORM_ROTATE_RIGHT;
+		eventQueue.clear();
+		for (int l = 0; l < MAX_LANES; l++) earlyStep[l] = -1;
+		morphFrom = -1;
 	}
 
 	int firstActivePattern() {
@@ -195,16 +438,115 @@ struct Beat : Module {
 		return from;
 	}
 
-	void fireStepIfActive() {
+	// Where a step's first hit lands relative to its clock, in steps: its
+	// nudge, plus the lane's swing on the off-beats (100% = half a step late)
+	float stepOffset(const Lane& lane, int l, int step) {
+		float offset = lane.nudges[step];
+		if (step & 1) offset += params[SWING_PARAM_0 + l].getValue() * 0.5f;
+		return clamp(offset, -0.5f, 0.5f);
+	}
+
+	// Queue a step's hits, the first at `start`, a ratchet's spread evenly
+	// over one clock period. Probability is rolled here, once for all of them:
+	// p=1 always fires, p=0 never fires.
+	void queueHits(int l, const Lane& lane, int step, double start, double period, bool early) {
+		if (!lane.stepOn(step)) return;
+		if (random::uniform() >= lane.probabilities[step]) return;
+		int hits = (period > 0.0) ? lane.ratchets[step] : 1;
+		double spacing = (hits > 1) ? period / hits : 0.0;
+		StepEvent e;
+		e.velocity = clamp(lane.velocities[step], 0.f, 1.f);
+		e.spacing = (float)spacing;
+		e.lane = (uint8_t)l;
+		e.early = early;
+		for (int h = 0; h < hits; h++) {
+			e.time = start + h * spacing;
+			e.accent = (h == 0) && lane.accentOn(step);
+			eventQueue.push(e);
+		}
+	}
+
+	float morphCv() {
+		return clamp(inputs[MORPH_INPUT].getVoltage() / 10.f, 0.f, 1.f);
+	}
+
+	// Blend each lane of the playing pattern with the same lane of the next
+	// active one. A step's chance to fire is the two on/off states weighted
+	// by the morph, each carrying its own probability. Velocity and nudge are
+	// blended across the patterns the step is on in; the accent is kept when
+	// those holding it have at least half that weight, and the ratchet count
+	// comes from the heavier side. Steps past the next pattern's length count
+	// as off in it.
+	void buildMorph(float amount) {
+		morphFrom = playPattern;
+		morphTo = nextActivePattern(playPattern);
+		morphAmount = amount;
+		const Pattern& a = patterns[morphFrom];
+		const Pattern& b = patterns[morphTo];
+		uint16_t bSteps = lengthMask(b.length);
+		for (int l = 0; l < numLanes; l++) {
+			const Lane& la = a.lanes[l];
+			const Lane& lb = b.lanes[l];
+			Lane& out = morphLanes[l];
+			out.clear();
+			for (int i = 0; i < MAX_STEPS; i++) {
+				float wa = la.stepOn(i) ? 1.f - amount : 0.f;
+				float wb = (lb.stepOn(i) && ((bSteps >> i) & 1)) ? amount : 0.f;
+				float w = wa + wb;
+				if (w <= 0.f) continue;
+				out.setStep(i, true);
+				out.probabilities[i] = wa * la.probabilities[i] + wb * lb.probabilities[i];
+				out.velocities[i] = (wa * la.velocities[i] + wb * lb.velocities[i]) / w;
+				out.nudges[i] = (wa * la.nudges[i] + wb * lb.nudges[i]) / w;
+				out.ratchets[i] = (wa >= wb) ? la.ratchets[i] : lb.ratchets[i];
+				float acc = (la.accentOn(i) ? wa : 0.f) + (lb.accentOn(i) ? wb : 0.f);
+				out.setAccent(i, acc >= 0.5f * w);
+			}
+		}
+	}
+
+	// Called as the playhead lands on playStep. Offsets are fractions of the
+	// measured clock period; until there is one, every hit goes out on its
+	// clock. A step due early is queued one clock ahead, while the step before
+	// it plays. Step 0 never is: what follows a bar isn't known until the BAR
+	// arrives, so an early step 0 plays on the downbeat.
+	void scheduleStep() {
 		const Pattern& p = patterns[playPattern];
 		if (playStep < 0 || playStep >= p.length) return;
-		if (!p.steps[playStep]) return;
-		// Probability check — fires only if random draw is below the set
-		// probability. p=1 always fires, p=0 never fires.
-		if (random::uniform() >= p.probabilities[playStep]) return;
-		gatePulse.trigger(0.001f);
-		currentVelocity = clamp(p.velocities[playStep], 0.f, 1.f);
-		if (p.accents[playStep]) accentPulse.trigger(0.001f);
+		double now = arbiter.now;
+		double period = arbiter.clockPeriod;
+		int next = playStep + 1;
+		bool morphing = inputs[MORPH_INPUT].isConnected();
+		if (morphing && (morphFrom != playPattern || morphTo != nextActivePattern(playPattern))) {
+			buildMorph(morphCv());
+		}
+		for (int l = 0; l < numLanes; l++) {
+			const Lane& lane = morphing ? morphLanes[l] : p.lanes[l];
+			if (earlyStep[l] != playStep) {
+				float offset = std::max(stepOffset(lane, l, playStep), 0.f);
+				queueHits(l, lane, playStep, now + offset * period, period, false);
+			}
+			earlyStep[l] = -1;
+			if (period > 0.0 && next < p.length) {
+				float offset = stepOffset(lane, l, next);
+				if (offset < 0.f) {
+					queueHits(l, lane, next, now + (1.f + offset) * period, period, true);
+					earlyStep[l] = next;
+				}
+			}
+		}
+	}
+
+	// Logic transforms combine with the same lane of the pattern that
+	// follows in the rotation. lane < 0 transforms every lane in use.
+	void applyTransform(int pattern, int lane, int op) {
+		Pattern& p = patterns[pattern];
+		const Pattern& other = patterns[nextActivePattern(pattern)];
+		int first = lane < 0 ? 0 : lane;
+		int last = lane < 0 ? numLanes - 1 : lane;
+		for (int l = first; l <= last; l++) {
+			p.lanes[l].transform(op, other.lanes[l], p.length);
+		}
 	}
 
 	void doReset() {
@@ -215,8 +557,9 @@ struct Beat : Module {
 		// Also clear any in-flight deferred clock so a stale CLOCK from
 		// just before Reset doesn't fire after the reset state is set.
 		firstClockPending = true;
-		pendingClockSamples = -1;
-		barSuppressionSamples = 0;
+		arbiter.reset();
+		eventQueue.clear();
+		for (int l = 0; l < MAX_LANES; l++) earlyStep[l] = -1;
 	}
 
 	void process(const ProcessArgs& args) override {
@@ -224,6 +567,23 @@ struct Beat : Module {
 			doReset();
 		}
 
+		if (xformTrigger.process(inputs[XFORM_INPUT].getVoltage(), 0.1f, 1.f)) {
+			int op = transformOp;
+			if (inputs[XFORM_CV_INPUT].isConnected()) {
+				op += (int)std::round(inputs[XFORM_CV_INPUT].getVoltage());
+			}
+			applyTransform(playPattern, -1, clamp(op, 0, NUM_TRANSFORMS - 1));
+		}
+
+		if (inputs[MORPH_INPUT].isConnected()) {
+			if (morphDivider.process()) buildMorph(morphCv());
+		}
+		else {
+			// Rebuilt from scratch when a cable goes back in
+			morphFrom = -1;
+			morphAmount = 0.f;
+		}
+
 		bool barConnected = inputs[BAR_INPUT].isConnected();
 
 		auto advanceBar = [&]() {
@@ -232,16 +592,18 @@ struct Beat : Module {
 				// incrementing past it.
 				firstClockPending = false;
 				playStep = 0;
-				fireStepIfActive();
+				scheduleStep();
 				return;
 			}
+			// A BAR before the pattern's end: the step queued early won't play
+			eventQueue.dropEarly();
 			currentBar++;
 			if (currentBar > patterns[playPattern].repeats) {
 				playPattern = nextActivePattern(playPattern);
 				currentBar = 1;
 			}
 			playStep = 0;
-			fireStepIfActive();
+			scheduleStep();
 		};
 
 		auto advanceStep = [&]() {
@@ -253,7 +615,7 @@ struct Beat : Module {
 				if (barConnected) return;
 				firstClockPending = false;
 				playStep = 0;
-				fireStepIfActive();
+				scheduleStep();
 				return;
 			}
 			int len = patterns[playPattern].length;
@@ -266,49 +628,117 @@ struct Beat : Module {
 				advanceBar();
 			} else {
 				playStep = nextStep % len;
-				fireStepIfActive();
+				scheduleStep();
 			}
 		};
 
-		bool barFired = barConnected
-			&& barTrigger.process(inputs[BAR_INPUT].getVoltage(), 0.1f, 1.f);
-		if (barFired) {
-			// Cancel any deferred clock — the BAR is the canonical event.
-			pendingClockSamples = -1;
-			barSuppressionSamples = BAR_SUPPRESS_SAMPLES;
-			advanceBar();
-		}
-
-		bool clockFired = clockTrigger.process(inputs[CLOCK_INPUT].getVoltage(), 0.1f, 1.f);
-		if (clockFired && !barFired) {
-			if (barConnected) {
-				if (barSuppressionSamples > 0) {
-					// CLOCK in post-BAR window — same musical event, drop.
-				} else {
-					// Defer the CLOCK fire so a BAR arriving in the next
-					// few samples can cancel it.
-					pendingClockSamples = CLOCK_DEFER_SAMPLES;
-				}
-			} else {
-				// No BAR cable — fire CLOCK immediately.
-				advanceStep();
-			}
+		// Without a BAR cable CLOCK fires immediately; with one, CLOCKs are
+		// deferred briefly so a BAR landing close by can claim the downbeat
+		ClockArbiter::Events edges = arbiter.process(
+			inputs[CLOCK_INPUT].getVoltage(), inputs[BAR_INPUT].getVoltage(),
+			barConnected, args.sampleTime);
+		if (edges.bar) advanceBar();
+		if (edges.clock) advanceStep();
+
+		// Hits that are due; most samples there are none. Ratchet hits get
+		// pulses short enough to leave a gap before the next one.
+		while (eventQueue.due(arbiter.now)) {
+			StepEvent e = eventQueue.pop();
+			if (e.lane >= numLanes) continue;
+			float pulseLen = 0.001f;
+			if (e.spacing > 0.f) pulseLen = std::min(pulseLen, 0.5f * e.spacing * args.sampleTime);
+			gatePulse[e.lane].trigger(pulseLen);
+			currentVelocity[e.lane] = e.velocity;
+			if (e.accent) accentPulse[e.lane].trigger(pulseLen);
 		}
-		if (pendingClockSamples > 0) {
-			pendingClockSamples--;
-			if (pendingClockSamples == 0) {
-				advanceStep();
-				pendingClockSamples = -1;
-			}
+
+		outputs[GATE_OUTPUT].setChannels(numLanes);
+		outputs[VELOCITY_OUTPUT].setChannels(numLanes);
+		outputs[ACCENT_OUTPUT].setChannels(numLanes);
+		for (int l = 0; l < numLanes; l++) {
+			bool gateHi = gatePulse[l].process(args.sampleTime);
+			bool accHi = accentPulse[l].process(args.sampleTime);
+			outputs[GATE_OUTPUT].setVoltage(gateHi ? 10.f : 0.f, l);
+			outputs[VELOCITY_OUTPUT].setVoltage(currentVelocity[l] * 10.f, l);
+			outputs[ACCENT_OUTPUT].setVoltage(accHi ? 10.f : 0.f, l);
 		}
-		if (barSuppressionSamples > 0) barSuppressionSamples--;
+	}
 
-		bool gateHi = gatePulse.process(args.sampleTime);
-		bool accHi = accentPulse.process(args.sampleTime);
+	// A lane's steps go in the object they're given: the pattern object
+	// itself for lane 0 (the layout single-lane patches always had), an
+	// entry of its "lanes" array for the rest
+	static void laneToJson(const Lane& lane, json_t* obj) {
+		json_object_set_new(obj, "stepMask", json_integer(lane.steps));
+		json_object_set_new(obj, "accentMask", json_integer(lane.accents));
+		json_t* velsArr = json_array();
+		json_t* probsArr = json_array();
+		for (int s = 0; s < MAX_STEPS; s++) {
+			json_array_append_new(velsArr, json_real(lane.velocities[s]));
+			json_array_append_new(probsArr, json_real(lane.probabilities[s]));
+		}
+		json_object_set_new(obj, "velocities", velsArr);
+		json_object_set_new(obj, "probabilities", probsArr);
+		// Timing is only written once a step has some
+		bool timed = false;
+		for (int s = 0; s < MAX_STEPS; s++) {
+			if (lane.nudges[s] != 0.f || lane.ratchets[s] != 1) timed = true;
+		}
+		if (timed) {
+			json_t* nudgesArr = json_array();
+			json_t* ratchetsArr = json_array();
+			for (int s = 0; s < MAX_STEPS; s++) {
+				json_array_append_new(nudgesArr, json_real(lane.nudges[s]));
+				json_array_append_new(ratchetsArr, json_integer(lane.ratchets[s]));
+			}
+			json_object_set_new(obj, "nudges", nudgesArr);
+			json_object_set_new(obj, "ratchets", ratchetsArr);
+		}
+	}
 
-		outputs[GATE_OUTPUT].setVoltage(gateHi ? 10.f : 0.f);
-		outputs[VELOCITY_OUTPUT].setVoltage(currentVelocity * 10.f);
-		outputs[ACCENT_OUTPUT].setVoltage(accHi ? 10.f : 0.f);
+	static void laneFromJson(Lane& lane, json_t* obj) {
+		// Older patches saved steps and accents as arrays of booleans
+		if (json_t* j = json_object_get(obj, "stepMask")) {
+			lane.steps = (uint16_t)json_integer_value(j);
+		}
+		else if (json_t* arr = json_object_get(obj, "steps")) {
+			for (int s = 0; s < MAX_STEPS; s++) {
+				if (json_t* v = json_array_get(arr, s))
+					lane.setStep(s, json_boolean_value(v));
+			}
+		}
+		if (json_t* j = json_object_get(obj, "accentMask")) {
+			lane.accents = (uint16_t)json_integer_value(j);
+		}
+		else if (json_t* arr = json_object_get(obj, "accents")) {
+			for (int s = 0; s < MAX_STEPS; s++) {
+				if (json_t* v = json_array_get(arr, s))
+					lane.setAccent(s, json_boolean_value(v));
+			}
+		}
+		if (json_t* arr = json_object_get(obj, "velocities")) {
+			for (int s = 0; s < MAX_STEPS; s++) {
+				if (json_t* v = json_array_get(arr, s))
+					lane.velocities[s] = clamp((float)json_real_value(v), 0.f, 1.f);
+			}
+		}
+		if (json_t* arr = json_object_get(obj, "probabilities")) {
+			for (int s = 0; s < MAX_STEPS; s++) {
+				if (json_t* v = json_array_get(arr, s))
+					lane.probabilities[s] = clamp((float)json_real_value(v), 0.f, 1.f);
+			}
+		}
+		if (json_t* arr = json_object_get(obj, "nudges")) {
+			for (int s = 0; s < MAX_STEPS; s++) {
+				if (json_t* v = json_array_get(arr, s))
+					lane.nudges[s] = clamp((float)json_real_value(v), -0.5f, 0.5f);
+			}
+		}
+		if (json_t* arr = json_object_get(obj, "ratchets")) {
+			for (int s = 0; s < MAX_STEPS; s++) {
+				if (json_t* v = json_array_get(arr, s))
+					lane.ratchets[s] = (uint8_t)clamp((int)json_integer_value(v), 1, MAX_RATCHETS);
+			}
+		}
 	}
 
 	json_t* dataToJson() override {
@@ -319,6 +749,18 @@ struct Beat : Module {
 		json_object_set_new(root, "playStep", json_integer(playStep));
 		json_object_set_new(root, "currentBar", json_integer(currentBar));
 		json_object_set_new(root, "advanceOnBarOnly", json_boolean(advanceOnBarOnly));
+		json_object_set_new(root, "transformOp", json_integer(transformOp));
+		json_object_set_new(root, "numLanes", json_integer(numLanes));
+		json_object_set_new(root, "editLane", json_integer(editLane));
+
+		// Lanes past the ones in use are kept while they hold any steps, so
+		// turning the lane count down and back up loses nothing
+		int savedLanes = numLanes;
+		for (int p = 0; p < NUM_PATTERNS; p++) {
+			for (int l = savedLanes; l < MAX_LANES; l++) {
+				if (patterns[p].lanes[l].steps) savedLanes = l + 1;
+			}
+		}
 
 		json_t* patArray = json_array();
 		for (int p = 0; p < NUM_PATTERNS; p++) {
@@ -326,20 +768,16 @@ struct Beat : Module {
 			json_object_set_new(patObj, "active", json_boolean(patterns[p].active));
 			json_object_set_new(patObj, "length", json_integer(patterns[p].length));
 			json_object_set_new(patObj, "repeats", json_integer(patterns[p].repeats));
-			json_t* stepsArr = json_array();
-			json_t* velsArr = json_array();
-			json_t* accsArr = json_array();
-			json_t* probsArr = json_array();
-			for (int s = 0; s < MAX_STEPS; s++) {
-				json_array_append_new(stepsArr, json_boolean(patterns[p].steps[s]));
-				json_array_append_new(velsArr, json_real(patterns[p].velocities[s]));
-				json_array_append_new(accsArr, json_boolean(patterns[p].accents[s]));
-				json_array_append_new(probsArr, json_real(patterns[p].probabilities[s]));
+			laneToJson(patterns[p].lanes[0], patObj);
+			if (savedLanes > 1) {
+				json_t* lanesArr = json_array();
+				for (int l = 1; l < savedLanes; l++) {
+					json_t* laneObj = json_object();
+					laneToJson(patterns[p].lanes[l], laneObj);
+					json_array_append_new(lanesArr, laneObj);
+				}
+				json_object_set_new(patObj, "lanes", lanesArr);
 			}
-			json_object_set_new(patObj, "steps", stepsArr);
-			json_object_set_new(patObj, "velocities", velsArr);
-			json_object_set_new(patObj, "accents", accsArr);
-			json_object_set_new(patObj, "probabilities", probsArr);
 			json_array_append_new(patArray, patObj);
 		}
 		json_object_set_new(root, "patterns", patArray);
@@ -359,6 +797,12 @@ struct Beat : Module {
 			currentBar = clamp((int)json_integer_value(j), 1, MAX_REPEATS);
 		if (json_t* j = json_object_get(root, "advanceOnBarOnly"))
 			advanceOnBarOnly = json_boolean_value(j);
+		if (json_t* j = json_object_get(root, "transformOp"))
+			transformOp = clamp((int)json_integer_value(j), 0, NUM_TRANSFORMS - 1);
+		if (json_t* j = json_object_get(root, "numLanes"))
+			numLanes = clamp((int)json_integer_value(j), 1, MAX_LANES);
+		if (json_t* j = json_object_get(root, "editLane"))
+			editLane = clamp((int)json_integer_value(j), 0, numLanes - 1);
 
 		json_t* patArray = json_object_get(root, "patterns");
 		if (patArray && json_is_array(patArray)) {
@@ -371,29 +815,12 @@ struct Beat : Module {
 					patterns[p].length = clamp((int)json_integer_value(j), 1, MAX_STEPS);
 				if (json_t* j = json_object_get(patObj, "repeats"))
 					patterns[p].repeats = clamp((int)json_integer_value(j), 1, MAX_REPEATS);
-				if (json_t* arr = json_object_get(patObj, "steps")) {
-					for (int s = 0; s < MAX_STEPS; s++) {
-						if (json_t* v = json_array_get(arr, s))
-							patterns[p].steps[s] = json_boolean_value(v);
-					}
-				}
-				if (json_t* arr = json_object_get(patObj, "velocities")) {
-					for (int s = 0; s < MAX_STEPS; s++) {
-						if (json_t* v = json_array_get(arr, s))
-							patterns[p].velocities[s] = clamp((float)json_real_value(v), 0.f, 1.f);
-					}
-				}
-				if (json_t* arr = json_object_get(patObj, "accents")) {
-					for (int s = 0; s < MAX_STEPS; s++) {
-						if (json_t* v = json_array_get(arr, s))
-							patterns[p].accents[s] = json_boolean_value(v);
-					}
-				}
-				if (json_t* arr = json_object_get(patObj, "probabilities")) {
-					for (int s = 0; s < MAX_STEPS; s++) {
-						if (json_t* v = json_array_get(arr, s))
-							patterns[p].probabilities[s] = clamp((float)json_real_value(v), 0.f, 1.f);
-					}
+				laneFromJson(patterns[p].lanes[0], patObj);
+				json_t* lanesArr = json_object_get(patObj, "lanes");
+				for (int l = 1; l < MAX_LANES; l++) {
+					patterns[p].lanes[l].clear();
+					json_t* laneObj = lanesArr ? json_array_get(lanesArr, l - 1) : nullptr;
+					if (laneObj) laneFromJson(patterns[p].lanes[l], laneObj);
 				}
 			}
 		}
@@ -410,11 +837,13 @@ void BeatDisplay::computeLayout() {
 	float w = box.size.x;
 	float s = w / 174.f;
 
-	// 4 mode tabs (STEPS / VEL / ACC / PROB) of (38 x 18) at x = 7, 47, 87, 127, y = 8
-	for (int i = 0; i < 4; i++) {
+	// 6 mode tabs (STEPS / VEL / ACC / PROB / TIME / RAT) sharing the 158-unit
+	// width, 2 apart, y = 8
+	float tabPitch = 160.f / Beat::NUM_MODES;
+	for (int i = 0; i < Beat::NUM_MODES; i++) {
 		tabRect[i] = rack::math::Rect(
-			rack::math::Vec((7.f + i * 40.f) * s, 8.f * s),
-			rack::math::Vec(38.f * s, 18.f * s));
+			rack::math::Vec((7.f + i * tabPitch) * s, 8.f * s),
+			rack::math::Vec((tabPitch - 2.f) * s, 18.f * s));
 	}
 
 	// Step grid: 2 rows × 8 cols of (18 x 18) cells, x = 7, 27, 47, ..., 147
@@ -469,7 +898,7 @@ int BeatDisplay::hitTestPattern(rack::math::Vec p) {
 }
 
 int BeatDisplay::hitTestTab(rack::math::Vec p) {
-	for (int i = 0; i < 4; i++) {
+	for (int i = 0; i < Beat::NUM_MODES; i++) {
 		if (tabRect[i].contains(p)) return i;
 	}
 	return -1;
@@ -490,6 +919,29 @@ static int hitTestRepeats(BeatDisplay* d, rack::math::Vec p) {
 	return -1;
 }
 
+// The per-step value a drag edits in each mode, as 0..1. TIME: 0 = half a
+// step early, 1 = half a step late. RAT: 0 = one hit, 1 = MAX_RATCHETS.
+static float stepValue(const Beat::Lane& lane, int mode, int step) {
+	switch (mode) {
+		case Beat::MODE_PROB: return lane.probabilities[step];
+		case Beat::MODE_TIME: return lane.nudges[step] + 0.5f;
+		case Beat::MODE_RAT: return (lane.ratchets[step] - 1) / (float)(Beat::MAX_RATCHETS - 1);
+		default: return lane.velocities[step];
+	}
+}
+
+static void setStepValue(Beat::Lane& lane, int mode, int step, float v) {
+	v = clamp(v, 0.f, 1.f);
+	switch (mode) {
+		case Beat::MODE_PROB: lane.probabilities[step] = v; break;
+		case Beat::MODE_TIME: lane.nudges[step] = v - 0.5f; break;
+		case Beat::MODE_RAT:
+			lane.ratchets[step] = (uint8_t)(1 + (int)std::round(v * (Beat::MAX_RATCHETS - 1)));
+			break;
+		default: lane.velocities[step] = v; break;
+	}
+}
+
 void BeatDisplay::onButton(const ButtonEvent& e) {
 	if (!module) {
 		OpaqueWidget::onButton(e);
@@ -555,16 +1007,17 @@ void BeatDisplay::onButton(const ButtonEvent& e) {
 	int step = hitTestStep(p);
 	if (step >= 0) {
 		Beat::Pattern& pat = module->patterns[module->editPattern];
+		Beat::Lane& lane = pat.lanes[module->editLane];
 		if (step >= pat.length) {
 			// Click beyond current length: extend length to include this step
 			pat.length = step + 1;
 		}
 		switch (module->editMode) {
 			case Beat::MODE_STEPS:
-				pat.steps[step] = !pat.steps[step];
+				lane.setStep(step, !lane.stepOn(step));
 				// Drag from here paints subsequent cells with this new state
 				dragKind = DRAG_STEP_PAINT;
-				paintState = pat.steps[step];
+				paintState = lane.stepOn(step);
 				break;
 			case Beat::MODE_VEL: {
 				// Click sets velocity based on Y within cell; drag continues
@@ -573,17 +1026,17 @@ void BeatDisplay::onButton(const ButtonEvent& e) {
 				rack::math::Rect cr = cellRectForStep(step);
 				float relY = (p.y - cr.pos.y) / cr.size.y;
 				float vel = clamp(1.f - relY, 0.f, 1.f);
-				pat.velocities[step] = vel;
-				if (!pat.steps[step]) pat.steps[step] = true;
+				lane.velocities[step] = vel;
+				lane.setStep(step, true);
 				dragStartY = p.y;
 				dragStartVel = vel;
 				break;
 			}
 			case Beat::MODE_ACC:
-				pat.accents[step] = !pat.accents[step];
-				if (pat.accents[step] && !pat.steps[step]) pat.steps[step] = true;
+				lane.setAccent(step, !lane.accentOn(step));
+				if (lane.accentOn(step)) lane.setStep(step, true);
 				dragKind = DRAG_ACC_PAINT;
-				paintState = pat.accents[step];
+				paintState = lane.accentOn(step);
 				break;
 			case Beat::MODE_PROB: {
 				// Same vertical-drag behavior as VEL (reuses DRAG_VEL kind)
@@ -592,8 +1045,26 @@ void BeatDisplay::onButton(const ButtonEvent& e) {
 				rack::math::Rect cr = cellRectForStep(step);
 				float relY = (p.y - cr.pos.y) / cr.size.y;
 				float val = clamp(1.f - relY, 0.f, 1.f);
-				pat.probabilities[step] = val;
-				if (!pat.steps[step]) pat.steps[step] = true;
+				lane.probabilities[step] = val;
+				lane.setStep(step, true);
+				dragStartY = p.y;
+				dragStartVel = val;
+				break;
+			}
+			case Beat::MODE_TIME:
+			case Beat::MODE_RAT: {
+				// TIME: click position across the cell sets the nudge, the
+				// middle is on the clock; horizontal drag continues.
+				// RAT: click height sets the hit count, like VEL.
+				dragStep = step;
+				dragKind = DRAG_VEL;
+				rack::math::Rect cr = cellRectForStep(step);
+				float val = (module->editMode == Beat::MODE_TIME)
+					? (p.x - cr.pos.x) / cr.size.x
+					: 1.f - (p.y - cr.pos.y) / cr.size.y;
+				val = clamp(val, 0.f, 1.f);
+				setStepValue(lane, module->editMode, step, val);
+				lane.setStep(step, true);
 				dragStartY = p.y;
 				dragStartVel = val;
 				break;
@@ -639,13 +1110,15 @@ void BeatDisplay::onDragMove(const DragMoveEvent& e) {
 		case DRAG_VEL: {
 			if (dragStep >= 0) {
 				rack::math::Rect cr = cellRectForStep(dragStep);
-				float deltaVal = -delta.y / cr.size.y;
+				float deltaVal = (module->editMode == Beat::MODE_TIME)
+					? delta.x / cr.size.x
+					: -delta.y / cr.size.y;
 				Beat::Pattern& pat = module->patterns[module->editPattern];
-				// Dispatches between velocity / probability based on mode
-				float* target = (module->editMode == Beat::MODE_PROB)
-					? &pat.probabilities[dragStep]
-					: &pat.velocities[dragStep];
-				*target = clamp(*target + deltaVal, 0.f, 1.f);
+				Beat::Lane& lane = pat.lanes[module->editLane];
+				// Accumulated here rather than read back, so ratchets, which
+				// snap to whole hits, still follow a slow drag
+				dragStartVel = clamp(dragStartVel + deltaVal, 0.f, 1.f);
+				setStepValue(lane, module->editMode, dragStep, dragStartVel);
 			}
 			break;
 		}
@@ -653,8 +1126,9 @@ void BeatDisplay::onDragMove(const DragMoveEvent& e) {
 			int step = hitTestStep(dragPos);
 			if (step >= 0) {
 				Beat::Pattern& pat = module->patterns[module->editPattern];
+				Beat::Lane& lane = pat.lanes[module->editLane];
 				if (step < pat.length) {
-					pat.steps[step] = paintState;
+					lane.setStep(step, paintState);
 				}
 			}
 			break;
@@ -663,9 +1137,10 @@ void BeatDisplay::onDragMove(const DragMoveEvent& e) {
 			int step = hitTestStep(dragPos);
 			if (step >= 0) {
 				Beat::Pattern& pat = module->patterns[module->editPattern];
+				Beat::Lane& lane = pat.lanes[module->editLane];
 				if (step < pat.length) {
-					pat.accents[step] = paintState;
-					if (paintState && !pat.steps[step]) pat.steps[step] = true;
+					lane.setAccent(step, paintState);
+					if (paintState) lane.setStep(step, true);
 				}
 			}
 			break;
@@ -724,6 +1199,13 @@ void BeatDisplay::onHoverScroll(const HoverScrollEvent& e) {
 		e.consume(this);
 		return;
 	}
+	// Over the step grid: pick the lane to edit
+	if (module->numLanes > 1 && hitTestStep(e.pos) >= 0) {
+		int delta = (e.scrollDelta.y > 0.f) ? -1 : 1;
+		module->editLane = clamp(module->editLane + delta, 0, module->numLanes - 1);
+		e.consume(this);
+		return;
+	}
 	OpaqueWidget::onHoverScroll(e);
 }
 
@@ -753,14 +1235,15 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 	const NVGcolor COL_HINT       = nvgRGBA(0xFF, 0xFF, 0xFF, 26);    // ~10% white
 
 	const Beat::Pattern& editPat = module->patterns[module->editPattern];
+	const Beat::Lane& editLane = editPat.lanes[module->editLane];
 	bool isPlayingPattern = (module->editPattern == module->playPattern);
 
 	float w = box.size.x;
 	float s = w / 174.f;  // mockup-unit → pixel scale, used for stroke widths etc.
 
-	// --- Mode tabs (4): STEPS / VEL / ACC / PROB ---
-	const char* tabLabels[4] = { "STEPS", "VEL", "ACC", "PROB" };
-	for (int i = 0; i < 4; i++) {
+	// --- Mode tabs (6): STEPS / VEL / ACC / PROB / TIME / RAT ---
+	const char* tabLabels[Beat::NUM_MODES] = { "STEPS", "VEL", "ACC", "PROB", "TIME", "RAT" };
+	for (int i = 0; i < Beat::NUM_MODES; i++) {
 		bool active = (module->editMode == i);
 		NVGcolor bg = active ? COL_BLUE_DARK : COL_PURPLE;
 		NVGcolor fg = active ? COL_TEXT_BRIGHT : COL_TEXT_DIM;
@@ -771,7 +1254,7 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 		nvgFill(args.vg);
 		if (font && font->handle >= 0) {
 			nvgFontFaceId(args.vg, font->handle);
-			nvgFontSize(args.vg, 9.f * s);
+			nvgFontSize(args.vg, 8.f * s);
 			nvgTextAlign(args.vg, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
 			nvgFillColor(args.vg, fg);
 			nvgText(args.vg,
@@ -785,7 +1268,7 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 	for (int idx = 0; idx < MAX_STEPS; idx++) {
 		rack::math::Rect cr = cellRectForStep(idx);
 		bool inLen = (idx < editPat.length);
-		bool stepOn = editPat.steps[idx];
+		bool stepOn = editLane.stepOn(idx);
 		bool isCurrent = isPlayingPattern && (idx == module->playStep);
 		bool beatStart = (idx % 4 == 0);
 
@@ -804,10 +1287,13 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 		if (!inLen) continue;
 
 		// Velocity overlay (bottom-up white). Bright in VEL mode, faint hint
-		// in STEPS / ACC modes. Skipped entirely in PROB mode (the PROB
-		// overlay below takes over).
-		if (stepOn && module->editMode != Beat::MODE_PROB) {
-			float v = clamp(editPat.velocities[idx], 0.f, 1.f);
+		// in STEPS / ACC modes. Skipped in PROB / TIME / RAT modes (their
+		// overlays below take over).
+		bool velVisible = module->editMode == Beat::MODE_STEPS
+			|| module->editMode == Beat::MODE_VEL
+			|| module->editMode == Beat::MODE_ACC;
+		if (stepOn && velVisible) {
+			float v = clamp(editLane.velocities[idx], 0.f, 1.f);
 			float overlayH = cr.size.y * v;
 			NVGcolor velColor = (module->editMode == Beat::MODE_VEL)
 				? nvgRGBA(255, 255, 255, 153)   // 60% white in VEL mode
@@ -822,7 +1308,7 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 
 		// Probability overlay (bottom-up white) — only in PROB mode.
 		if (stepOn && module->editMode == Beat::MODE_PROB) {
-			float prob = clamp(editPat.probabilities[idx], 0.f, 1.f);
+			float prob = clamp(editLane.probabilities[idx], 0.f, 1.f);
 			float overlayH = cr.size.y * prob;
 			nvgBeginPath(args.vg);
 			nvgRoundedRect(args.vg,
@@ -832,9 +1318,41 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 			nvgFill(args.vg);
 		}
 
+		// Nudge overlay — only in TIME mode: a bar from the cell's middle
+		// (on the clock) toward the left edge for early, right for late.
+		if (stepOn && module->editMode == Beat::MODE_TIME) {
+			float cx = cr.pos.x + cr.size.x * 0.5f;
+			float barW = editLane.nudges[idx] * cr.size.x;
+			nvgBeginPath(args.vg);
+			nvgRect(args.vg, std::min(cx, cx + barW), cr.pos.y,
+				std::fabs(barW), cr.size.y);
+			nvgFillColor(args.vg, nvgRGBA(255, 255, 255, 153));
+			nvgFill(args.vg);
+			nvgBeginPath(args.vg);
+			nvgMoveTo(args.vg, cx, cr.pos.y);
+			nvgLineTo(args.vg, cx, cr.pos.y + cr.size.y);
+			nvgStrokeColor(args.vg, COL_HINT);
+			nvgStrokeWidth(args.vg, 1.f);
+			nvgStroke(args.vg);
+		}
+
+		// Ratchet count — only in RAT mode, on steps that repeat
+		if (stepOn && module->editMode == Beat::MODE_RAT
+			&& editLane.ratchets[idx] > 1 && font && font->handle >= 0) {
+			nvgFontFaceId(args.vg, font->handle);
+			nvgFontSize(args.vg, 10.f * s);
+			nvgTextAlign(args.vg, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
+			nvgFillColor(args.vg, COL_TEXT_BRIGHT);
+			std::string ratLbl = string::f("%d", editLane.ratchets[idx]);
+			nvgText(args.vg,
+				cr.pos.x + cr.size.x * 0.5f,
+				cr.pos.y + cr.size.y * 0.5f,
+				ratLbl.c_str(), NULL);
+		}
+
 		// Accent ring (unfilled white circle). Full opacity in ACC mode,
 		// 20% as a hint in STEPS / VEL modes.
-		if (stepOn && editPat.accents[idx]) {
+		if (stepOn && editLane.accentOn(idx)) {
 			float r = std::min(cr.size.x, cr.size.y) * 0.39f;  // r=3.5 of 9 mockup units
 			NVGcolor accColor = (module->editMode == Beat::MODE_ACC)
 				? COL_TEXT_BRIGHT
@@ -901,6 +1419,19 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 			nvgStroke(args.vg);
 		}
 
+		// Morph target: orange outline, as bright as the morph is deep
+		if (module->morphAmount > 0.f && p == module->morphTo && !isPlay) {
+			nvgBeginPath(args.vg);
+			nvgRoundedRect(args.vg,
+				pr.pos.x + 0.5f, pr.pos.y + 0.5f,
+				pr.size.x - 1.f, pr.size.y - 1.f, 2.f * s);
+			NVGcolor morphCol = COL_ORANGE;
+			morphCol.a = module->morphAmount;
+			nvgStrokeColor(args.vg, morphCol);
+			nvgStrokeWidth(args.vg, 1.f);
+			nvgStroke(args.vg);
+		}
+
 		// Pattern number — slightly above center to leave room for the dots
 		if (font && font->handle >= 0) {
 			nvgFontFaceId(args.vg, font->handle);
@@ -977,7 +1508,8 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 		nvgStroke(args.vg);
 
 		// Stem: from active mode tab center down to (just past) the rail
-		float topStemX = (7.f + module->editMode * 40.f + 19.f) * s;
+		const rack::math::Rect& tab = tabRect[clamp(module->editMode, 0, Beat::NUM_MODES - 1)];
+		float topStemX = tab.pos.x + tab.size.x * 0.5f;
 		nvgBeginPath(args.vg);
 		nvgMoveTo(args.vg, topStemX, 28.f * s);
 		nvgLineTo(args.vg, topStemX, 32.5f * s);
@@ -1005,6 +1537,12 @@ void BeatDisplay::drawLayer(const DrawArgs& args, int layer) {
 		nvgTextAlign(args.vg, NVG_ALIGN_LEFT | NVG_ALIGN_BASELINE);
 		nvgFillColor(args.vg, COL_TEXT_BRIGHT);
 		nvgText(args.vg, 8.f * s, 103.f * s, "PATTERN", NULL);
+		// Lane being edited, right-aligned on the same line
+		if (module->numLanes > 1) {
+			nvgTextAlign(args.vg, NVG_ALIGN_RIGHT | NVG_ALIGN_BASELINE);
+			std::string laneLbl = string::f("LANE %d/%d", module->editLane + 1, module->numLanes);
+			nvgText(args.vg, 165.f * s, 103.f * s, laneLbl.c_str(), NULL);
+		}
 	}
 
 	OpaqueWidget::drawLayer(args, layer);
@@ -1034,6 +1572,14 @@ struct BeatWidget : ModuleWidget {
 		addInput(createInputCentered<PJ301MPort>(
 			mm2px(Vec(10.16f, 121.92f)), module, Beat::CLOCK_INPUT));
 
+		// CENTER column at x=25.4mm — top→bottom: MORPH, XFORM CV, XFORM
+		addInput(createInputCentered<PJ301MPort>(
+			mm2px(Vec(25.4f, 91.45f)),  module, Beat::MORPH_INPUT));
+		addInput(createInputCentered<PJ301MPort>(
+			mm2px(Vec(25.4f, 106.68f)), module, Beat::XFORM_CV_INPUT));
+		addInput(createInputCentered<PJ301MPort>(
+			mm2px(Vec(25.4f, 121.92f)), module, Beat::XFORM_INPUT));
+
 		// Outputs (RIGHT column at x=40.64mm on dark plate) — top→bottom: VEL, ACC, GATE
 		addOutput(createOutputCentered<PJ301MPort>(
 			mm2px(Vec(40.64f, 91.45f)),  module, Beat::VELOCITY_OUTPUT));
@@ -1052,25 +1598,55 @@ struct BeatWidget : ModuleWidget {
 			"Advance only on bar trigger", "",
 			&module->advanceOnBarOnly));
 
+		menu->addChild(new MenuSeparator);
+		std::vector<std::string> laneLabels;
+		for (int l = 1; l <= MAX_LANES; l++) laneLabels.push_back(string::f("%d", l));
+		menu->addChild(createIndexSubmenuItem("Lanes", laneLabels,
+			[=]() { return (size_t)(module->numLanes - 1); },
+			[=](size_t i) {
+				module->numLanes = (int)i + 1;
+				module->editLane = std::min(module->editLane, module->numLanes - 1);
+			}));
+		if (module->numLanes > 1) {
+			std::vector<std::string> editLabels(laneLabels.begin(), laneLabels.begin() + module->numLanes);
+			menu->addChild(createIndexSubmenuItem("Edit lane", editLabels,
+				[=]() { return (size_t)module->editLane; },
+				[=](size_t i) { module->editLane = std::min((int)i, module->numLanes - 1); }));
+		}
+		// Swing of the lane being edited
+		ui::Slider* swingSlider = new ui::Slider;
+		swingSlider->quantity = module->paramQuantities[Beat::SWING_PARAM_0 + module->editLane];
+		swingSlider->box.size.x = 200.f;
+		menu->addChild(swingSlider);
+
 		menu->addChild(new MenuSeparator);
 		menu->addChild(createMenuLabel("Patterns"));
-		menu->addChild(createMenuItem("Randomize current pattern steps", "",
+		bool multiLane = module->numLanes > 1;
+		menu->addChild(createMenuItem(multiLane ? "Randomize current lane steps" : "Randomize current pattern steps", "",
 			[=]() {
-				Beat::Pattern& p = module->patterns[module->editPattern];
+				Beat::Lane& lane = module->patterns[module->editPattern].lanes[module->editLane];
 				for (int i = 0; i < MAX_STEPS; i++) {
-					p.steps[i] = (random::uniform() < 0.5f);
+					lane.setStep(i, random::uniform() < 0.5f);
 				}
 			}));
-		menu->addChild(createMenuItem("Clear current pattern", "",
+		menu->addChild(createMenuItem(multiLane ? "Clear current lane" : "Clear current pattern", "",
 			[=]() {
-				Beat::Pattern& p = module->patterns[module->editPattern];
-				for (int i = 0; i < MAX_STEPS; i++) {
-					p.steps[i] = false;
-					p.accents[i] = false;
-					p.velocities[i] = 1.f;
-					p.probabilities[i] = 1.f;
+				module->patterns[module->editPattern].lanes[module->editLane].clear();
+			}));
+		static const std::vector<std::string> transformNames = {
+			"Rotate right", "Rotate left", "Invert", "Reverse", "Euclidean fill",
+			"AND next pattern", "OR next pattern", "XOR next pattern"
+		};
+		menu->addChild(createSubmenuItem("Transform current pattern", "",
+			[=](Menu* menu) {
+				for (int op = 0; op < Beat::NUM_TRANSFORMS; op++) {
+					menu->addChild(createMenuItem(transformNames[op], "",
+						[=]() { module->applyTransform(module->editPattern, module->editLane, op); }
+					));
 				}
 			}));
+		menu->addChild(createIndexPtrSubmenuItem("XFORM trigger at 0V",
+			transformNames, &module->transformOp));
 		menu->addChild(createMenuItem("Clear all patterns", "",
 			[=]() {
 				for (int p = 0; p < NUM_PATTERNS; p++) {
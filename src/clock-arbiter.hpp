@@ -0,0 +1,116 @@
+#pragma once
+#include <cstdint>
+
+// ─── Clock / Bar Arbitration ─────────────────────────────────────────────────
+// Shared by Beat and Note. CLOCK and BAR from Meter should land on the same
+// sample but can drift apart by a fraction of a millisecond either way, and
+// a downbeat must fire step 0 once, not twice. Two windows, both in seconds
+// so they mean the same thing at any sample rate:
+//   - a CLOCK waits CLOCK_DEFER_TIME before firing; a BAR arriving in that
+//     time cancels it, since the BAR's advance already covers step 0
+//   - a CLOCK within BAR_SUPPRESS_TIME after a BAR is the same musical
+//     event and is dropped
+// Edges are timestamped to a fraction of a sample by interpolating where the
+// input crossed the trigger threshold, so which edge came first, and whether
+// a window has run out, doesn't depend on where sample boundaries fall. On
+// the same sample a BAR is handled before a CLOCK, so ties always resolve
+// the same way.
+
+static const float CLOCK_DEFER_TIME = 0.5e-3f;
+static const float BAR_SUPPRESS_TIME = 2e-3f;
+
+// The measured clock period is forgotten, rather than updated, across a gap
+// this many times the last period or longer than CLOCK_MAX_PERIOD_TIME: that
+// is the transport pausing, not the tempo changing. The next two edges
+// measure it afresh.
+static const double CLOCK_GAP_RATIO = 4.0;
+static const float CLOCK_MAX_PERIOD_TIME = 2.f;
+
+struct ClockArbiter {
+	// Schmitt trigger with the thresholds the modules always used (0.1V /
+	// 1V), reporting where in the last sample the rising edge happened.
+	// Starts high, like dsp::SchmittTrigger, so an input that is already
+	// high when the module loads doesn't count as an edge.
+	struct EdgeDetector {
+		bool high = true;
+		float last = 0.f;
+
+		// Returns false, or true with `fraction` in (0, 1]: how far through
+		// the last sample the input reached the high threshold
+		bool process(float v, float& fraction) {
+			float prev = last;
+			last = v;
+			if (high) {
+				if (v <= 0.1f) high = false;
+				return false;
+			}
+			if (v < 1.f) return false;
+			high = true;
+			fraction = (v > prev) ? (1.f - prev) / (v - prev) : 1.f;
+			if (fraction <= 0.f || fraction > 1.f) fraction = 1.f;
+			return true;
+		}
+	};
+
+	struct Events {
+		bool bar = false;     // advance the bar (fires step 0)
+		bool clock = false;   // advance one step
+	};
+
+	EdgeDetector clockEdge, barEdge;
+	double now = 0.0;                 // samples processed, the time base for edges
+	double pendingClock = -1.0;       // time of a deferred CLOCK edge, < 0 = none
+	double lastBar = -1e30;           // time of the last BAR edge
+	double lastClock = -1.0;          // time of the last raw CLOCK edge
+	double clockPeriod = 0.0;         // samples between the last two, 0 = not known yet
+
+	void reset() {
+		pendingClock = -1.0;
+		lastBar = -1e30;
+		lastClock = -1.0;
+		clockPeriod = 0.0;
+	}
+
+	Events process(float clockV, float barV, bool barConnected, float sampleTime) {
+		Events ev;
+		now += 1.0;
+		// Windows close on the sample where they run out, one sample earlier
+		// than comparing against the full length: at 48kHz a deferred CLOCK
+		// fires 23 samples after the one its edge landed in, and a CLOCK 96
+		// samples after a BAR counts again, as the sample counters did
+		double deferSamples = CLOCK_DEFER_TIME / sampleTime - 1.0;
+		double suppressSamples = BAR_SUPPRESS_TIME / sampleTime - 1.0;
+
+		float fraction;
+		if (barConnected && barEdge.process(barV, fraction)) {
+			// The BAR is the canonical event: any deferred CLOCK goes with it
+			lastBar = now - 1.0 + fraction;
+			pendingClock = -1.0;
+			ev.bar = true;
+		}
+
+		if (clockEdge.process(clockV, fraction)) {
+			double t = now - 1.0 + fraction;
+			if (lastClock >= 0.0) {
+				double gap = t - lastClock;
+				bool paused = gap > CLOCK_MAX_PERIOD_TIME / sampleTime
+					|| (clockPeriod > 0.0 && gap > CLOCK_GAP_RATIO * clockPeriod);
+				clockPeriod = paused ? 0.0 : gap;
+			}
+			lastClock = t;
+			if (!barConnected) {
+				ev.clock = true;
+			}
+			else if (!ev.bar && t - lastBar > suppressSamples) {
+				pendingClock = t;
+			}
+		}
+
+		// Fire a deferred CLOCK once its window has passed with no BAR
+		if (pendingClock >= 0.0 && now - pendingClock > deferSamples) {
+			pendingClock = -1.0;
+			ev.clock = true;
+		}
+		return ev;
+	}
+};
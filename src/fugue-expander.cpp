@@ -49,7 +49,11 @@ struct FugueX : Module {
 		GATE_A_OUTPUT_0,
 		GATE_B_OUTPUT_0 = GATE_A_OUTPUT_0 + FUGUE_NUM_STEPS,
 		GATE_C_OUTPUT_0 = GATE_B_OUTPUT_0 + FUGUE_NUM_STEPS,
-		OUTPUTS_LEN = GATE_C_OUTPUT_0 + FUGUE_NUM_STEPS
+		// One 8-channel cable per voice, channel n = step n's trigger
+		POLY_A_OUTPUT = GATE_C_OUTPUT_0 + FUGUE_NUM_STEPS,
+		POLY_B_OUTPUT,
+		POLY_C_OUTPUT,
+		OUTPUTS_LEN
 	};
 
 	enum LightId {
@@ -63,19 +67,25 @@ struct FugueX : Module {
 
 	dsp::SchmittTrigger randSeqTrigger;
 	dsp::SchmittTrigger randSeqButtonTrigger;
-	bool randomizeRequested = false;
 	dsp::PulseGenerator triggerPulses[FUGUE_NUM_VOICES][FUGUE_NUM_STEPS];
+	dsp::ClockDivider lightDivider;
+	bool sleepFlash[FUGUE_NUM_VOICES] = {};   // clock seen since the last light update
+	FugueLinkReader linkReader;
+	FugueSectionWriter<ExpanderToFugueMessage> overrideWriter;
 
 	~FugueX() {
-		delete (ExpanderToFugueMessage*)leftExpander.producerMessage;
-		delete (ExpanderToFugueMessage*)leftExpander.consumerMessage;
+		delete (FugueBusMessage*)leftExpander.producerMessage;
+		delete (FugueBusMessage*)leftExpander.consumerMessage;
 	}
 
 	FugueX() {
 		config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
+		lightDivider.setDivision(512);
 
-		leftExpander.producerMessage = new ExpanderToFugueMessage();
-		leftExpander.consumerMessage = new ExpanderToFugueMessage();
+		// Overrides travel left toward Fugue; Fugue's state comes from its
+		// link, found by walking left (see fugueLink)
+		leftExpander.producerMessage = new FugueBusMessage();
+		leftExpander.consumerMessage = new FugueBusMessage();
 
 		configParam(RAND_SEQ_BUTTON_PARAM, 0.f, 1.f, 0.f, "Randomize Sequence");
 		configInput(RAND_SEQ_INPUT, "Randomize Sequence Trigger");
@@ -83,9 +93,9 @@ struct FugueX : Module {
 
 		const char* voiceNames[] = {"A", "B", "C"};
 		for (int v = 0; v < FUGUE_NUM_VOICES; v++) {
-			configSwitch(STEPS_A_PARAM + v, 1.f, 8.f, 8.f,
-				string::f("Steps %s", voiceNames[v]),
-				{"1", "2", "3", "4", "5", "6", "7", "8"});
+			configParam(STEPS_A_PARAM + v, 1.f, (float)FUGUE_MAX_STEPS, (float)FUGUE_MAX_STEPS,
+				string::f("Steps %s", voiceNames[v]));
+			paramQuantities[STEPS_A_PARAM + v]->snapEnabled = true;
 			configSwitch(RANGE_A_PARAM + v, 0.f, 2.f, 0.f,
 				string::f("Range %s", voiceNames[v]),
 				{"1V", "2V", "5V"});
@@ -112,67 +122,74 @@ struct FugueX : Module {
 				                        GATE_C_OUTPUT_0 + s;
 				configOutput(outIdx, string::f("Gate %s Step %d", voiceNames[v], s + 1));
 			}
+			configOutput(POLY_A_OUTPUT + v, string::f("Gate %s Steps 1-8 (poly)", voiceNames[v]));
 		}
 	}
 
 	void process(const ProcessArgs& args) override {
-		bool hasFugue = (leftExpander.module && leftExpander.module->model == modelFugue);
-
-		// ── Read Fugue state ──
-		FugueToExpanderMessage fugueState = {};
-		if (hasFugue) {
-			FugueToExpanderMessage* rxMsg =
-				(FugueToExpanderMessage*)leftExpander.module->rightExpander.consumerMessage;
-			if (rxMsg) {
-				fugueState = *rxMsg;
-			}
-		}
+		// ── Read Fugue state straight from its link ──
+		linkReader.attach(fugueLink(leftExpander.module));
+		bool hasFugue = linkReader.link != nullptr;
+		linkReader.readState();
+		const FugueToExpanderMessage& fugueState = linkReader.state;
 
 		// ── Randomize trigger ──
 		bool randBtn = randSeqButtonTrigger.process(params[RAND_SEQ_BUTTON_PARAM].getValue());
 		bool randTrig = randSeqTrigger.process(inputs[RAND_SEQ_INPUT].getVoltage(), 0.1f, 1.f);
-		randomizeRequested = (randBtn || randTrig);
+		if (randBtn || randTrig) linkReader.requestRandomize();
 
-		// ── S&H light ──
 		bool sampleHold = params[SAMPLE_HOLD_PARAM].getValue() > 0.5f;
-		lights[SAMPLE_HOLD_LIGHT].setBrightness(sampleHold ? 1.f : 0.f);
 
 		// ── Build override message for Fugue ──
-		ExpanderToFugueMessage* txMsg = (ExpanderToFugueMessage*)leftExpander.producerMessage;
-		if (txMsg) {
-			txMsg->connected = true;
-			txMsg->randomizeRequested = randomizeRequested;
-			txMsg->sampleHoldEnabled = sampleHold;
+		FugueBusMessage* txBus = (FugueBusMessage*)leftExpander.producerMessage;
+		if (txBus && isFugueBusSource(leftExpander.module)) {
+			// Zeroed so the section writer only bumps its revision on real changes
+			ExpanderToFugueMessage overrides;
+			std::memset(&overrides, 0, sizeof(overrides));
+			overrides.connected = true;
+			overrides.sampleHoldEnabled = sampleHold;
 
 			for (int v = 0; v < FUGUE_NUM_VOICES; v++) {
 				int steps = (int)std::round(params[STEPS_A_PARAM + v].getValue());
 				if (inputs[STEPS_A_INPUT + v].isConnected()) {
 					steps += (int)std::round(inputs[STEPS_A_INPUT + v].getVoltage());
-					steps = clamp(steps, 1, 8);
+					steps = clamp(steps, 1, FUGUE_MAX_STEPS);
 				}
-				txMsg->voices[v].stepsOverride = steps;
+				overrides.voices[v].stepsOverride = steps;
 
 				int rangeIdx = (int)std::round(params[RANGE_A_PARAM + v].getValue());
 				if (inputs[RANGE_A_INPUT + v].isConnected()) {
 					rangeIdx += (int)std::round(inputs[RANGE_A_INPUT + v].getVoltage());
 					rangeIdx = clamp(rangeIdx, 0, 2);
 				}
-				txMsg->voices[v].rangeOverride = RANGE_VALUES[rangeIdx];
+				overrides.voices[v].rangeOverride = RANGE_VALUES[rangeIdx];
 
 				int sleepIdx = (int)std::round(params[SLEEP_A_PARAM + v].getValue());
 				if (inputs[SLEEP_A_INPUT + v].isConnected()) {
 					sleepIdx += (int)std::round(inputs[SLEEP_A_INPUT + v].getVoltage());
 					sleepIdx = clamp(sleepIdx, 0, NUM_SLEEP_VALUES - 1);
 				}
-				txMsg->voices[v].sleepDivision = SLEEP_VALUES[sleepIdx];
+				overrides.voices[v].sleepDivision = SLEEP_VALUES[sleepIdx];
 
 				float prob = params[PROB_A_PARAM + v].getValue();
 				if (inputs[PROB_A_INPUT + v].isConnected()) {
 					prob += inputs[PROB_A_INPUT + v].getVoltage() / 5.f;
 				}
-				txMsg->voices[v].probability = clamp(prob, 0.f, 1.f);
+				overrides.voices[v].probability = clamp(prob, 0.f, 1.f);
 			}
 
+			// Ours first, then whatever the expanders further right sent
+			txBus->clear();
+			overrideWriter.write(*txBus, FUGUE_SECTION_OVERRIDES, id, overrides);
+			if (isFugueExpander(rightExpander.module)) {
+				const FugueBusMessage* fromRight =
+					(const FugueBusMessage*)rightExpander.module->leftExpander.consumerMessage;
+				if (fromRight) {
+					for (const FugueSectionHeader* section = fromRight->first(); section; section = fromRight->next(section)) {
+						txBus->forward(section);
+					}
+				}
+			}
 			leftExpander.requestMessageFlip();
 		}
 
@@ -193,31 +210,48 @@ struct FugueX : Module {
 			outputs[MIN_OUTPUT].setVoltage(0.f);
 		}
 
+		// ── Clock edges since the last sample ──
+		// An edge Fugue published after we ran last frame arrives a frame
+		// late; its trigger is shortened by that much so it still ends with
+		// Fugue's. Longer sequences fold onto the 8 columns: a jack fires
+		// for its step on every page.
+		FugueEdgeEvent edge;
+		while (linkReader.nextEdge(edge)) {
+			if (edge.voice < 0 || edge.voice >= FUGUE_NUM_VOICES) continue;
+			sleepFlash[edge.voice] = true;
+			if (!edge.gateOn || edge.step < 0) continue;
+			float late = (float)std::max(args.frame - edge.frame, (int64_t)0) * args.sampleTime;
+			if (late < 1e-3f) {
+				triggerPulses[edge.voice][edge.step % FUGUE_NUM_STEPS].trigger(1e-3f - late);
+			}
+		}
+
 		// ── Per-step trigger outputs ──
 		for (int v = 0; v < FUGUE_NUM_VOICES; v++) {
 			int gateBaseOutput = (v == 0) ? GATE_A_OUTPUT_0 :
 			                     (v == 1) ? GATE_B_OUTPUT_0 :
 			                                GATE_C_OUTPUT_0;
 
-			if (hasFugue && fugueState.voices[v].clockRose && fugueState.voices[v].gateOn) {
-				int step = fugueState.voices[v].currentStep;
-				if (step >= 0 && step < FUGUE_NUM_STEPS) {
-					triggerPulses[v][step].trigger(1e-3f);
-				}
-			}
-
+			Output& poly = outputs[POLY_A_OUTPUT + v];
+			poly.setChannels(FUGUE_NUM_STEPS);
 			for (int s = 0; s < FUGUE_NUM_STEPS; s++) {
-				bool pulse = triggerPulses[v][s].process(args.sampleTime);
-				outputs[gateBaseOutput + s].setVoltage(pulse ? 10.f : 0.f);
+				float out = triggerPulses[v][s].process(args.sampleTime) ? 10.f : 0.f;
+				outputs[gateBaseOutput + s].setVoltage(out);
+				poly.setVoltage(out, s);
 			}
 		}
 
+		// ── Lights, at a fraction of the sample rate ──
+		if (!lightDivider.process()) return;
+
+		lights[SAMPLE_HOLD_LIGHT].setBrightness(sampleHold ? 1.f : 0.f);
+
 		// ── LED matrix: step indicators (cols 1-8, red) ──
 		for (int step = 0; step < FUGUE_NUM_STEPS; step++) {
 			for (int v = 0; v < FUGUE_NUM_VOICES; v++) {
 				int lightIdx = STEP_LED_0 + step * FUGUE_NUM_VOICES + v;
 				if (hasFugue) {
-					bool isCurrentStep = (fugueState.voices[v].currentStep == step);
+					bool isCurrentStep = (fugueState.voices[v].currentStep % FUGUE_NUM_STEPS == step);
 					bool gateOn = fugueState.voices[v].gateOn;
 					bool isSleeping = fugueState.voices[v].sleeping;
 					// Show current step brightly if gate is on and not sleeping
@@ -241,14 +275,15 @@ struct FugueX : Module {
 				float progress = (div > 0) ? 1.f - (float)counter / (float)div : 1.f;
 				// Minimum brightness 0.15 so it's always visible when sleeping
 				float brightness = 0.15f + progress * 0.85f;
-				// Flash on clock pulse
-				if (fugueState.voices[v].clockRose) {
+				// Flash on a clock pulse since the last update
+				if (sleepFlash[v]) {
 					brightness = 1.f;
 				}
 				lights[SLEEP_LED_0 + v].setBrightness(brightness);
 			} else {
 				lights[SLEEP_LED_0 + v].setBrightness(0.f);
 			}
+			sleepFlash[v] = false;
 		}
 	}
 };
@@ -292,6 +327,7 @@ struct FugueXWidget : ModuleWidget {
 		const float gateBY = 106.68f;
 		const float gateCY = 116.83f;
 		const float minMidMaxX = 111.76f;
+		const float polyX = 93.98f;
 
 		// ══════════════════════════════════════════════════════════════════════
 		// TOP SECTION
@@ -357,6 +393,11 @@ struct FugueXWidget : ModuleWidget {
 		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(minMidMaxX, gateBY)), module, FugueX::MID_OUTPUT));
 		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(minMidMaxX, gateCY)), module, FugueX::MIN_OUTPUT));
 
+		// Poly trigger outputs, one per voice row
+		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(polyX, gateAY)), module, FugueX::POLY_A_OUTPUT));
+		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(polyX, gateBY)), module, FugueX::POLY_B_OUTPUT));
+		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(polyX, gateCY)), module, FugueX::POLY_C_OUTPUT));
+
 		for (int s = 0; s < FUGUE_NUM_STEPS; s++) {
 			float x = gateStartX + s * gateSpacing;
 			addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(x, gateAY)), module, FugueX::GATE_A_OUTPUT_0 + s));
@@ -1,15 +1,19 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 
-static const int FUGUE_NUM_STEPS = 8;
+static const int FUGUE_NUM_STEPS = 8;    // step columns on the panels
+static const int FUGUE_MAX_STEPS = 64;   // sequence length limit
 static const int FUGUE_NUM_VOICES = 3;
 
 // Fugue → FugueX: voice state for display and trigger generation
 struct FugueToExpanderMessage {
-	int numSteps;
+	int numSteps;             // 1-64
 	struct VoiceInfo {
-		int currentStep;
+		int currentStep;      // index into the sequence, 0..numSteps-1
 		bool clockHigh;
-		bool clockRose;      // true on the sample the clock triggered
+		bool clockRose;      // true on the sample the clock triggered (edges also go through the link's event ring)
 		float currentVoltage;
 		bool gateOn;          // gate toggle state for current step
 		bool sleeping;        // voice is in sleep state
@@ -21,12 +25,295 @@ struct FugueToExpanderMessage {
 // FugueX → Fugue: control overrides
 struct ExpanderToFugueMessage {
 	bool connected;
-	bool randomizeRequested;
 	bool sampleHoldEnabled;
 	struct VoiceOverride {
-		int stepsOverride;    // -1 = no override, else 1-8 (capped at global)
+		int stepsOverride;    // -1 = no override, else 1-64 (capped at global)
 		float rangeOverride;  // -1 = no override, else 1.f/2.f/5.f
 		int sleepDivision;    // 0 = no sleep, else number of clocks to sleep after cycle
 		float probability;    // 0-1, gate fire probability (1.0 = always)
 	} voices[FUGUE_NUM_VOICES];
 };
+
+// ─── Expander Bus ────────────────────────────────────────────────────────────
+// Every expander message is a FugueBusMessage: a versioned header followed by
+// typed sections, each carrying one of the structs above as its payload.
+// Override sections travel leftward, each expander putting its own ahead of
+// the ones it received, so the expander nearest Fugue comes first. Fugue's
+// own state goes to expanders through FugueLink below.
+//
+// Compatibility rules: readers skip section types they don't know, and
+// section payloads only ever grow by appending fields. A reader copies the
+// bytes it understands and zero-fills the rest.
+//
+// Each section has a revision that its writer bumps only when the payload
+// changes; readers copy a payload only when (origin, revision) moves.
+
+static const uint32_t FUGUE_BUS_MAGIC = 0x46554742;   // "FUGB"
+static const uint16_t FUGUE_BUS_VERSION = 1;
+static const uint32_t FUGUE_BUS_CAPACITY = 1024;
+
+enum FugueSectionType : uint16_t {
+	FUGUE_SECTION_OVERRIDES = 2,     // ExpanderToFugueMessage, expanders → Fugue
+};
+
+struct FugueBusHeader {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t numSections;
+	uint32_t length;        // payload bytes in use
+};
+
+struct FugueSectionHeader {
+	uint16_t type;
+	uint16_t version;
+	uint32_t length;        // payload bytes following this header
+	uint32_t revision;
+	int64_t origin;         // module ID of the writer, kept when forwarded
+};
+
+struct FugueBusMessage {
+	FugueBusHeader header;
+	alignas(8) uint8_t payload[FUGUE_BUS_CAPACITY];
+
+	FugueBusMessage() {
+		clear();
+	}
+
+	void clear() {
+		header.magic = FUGUE_BUS_MAGIC;
+		header.version = FUGUE_BUS_VERSION;
+		header.numSections = 0;
+		header.length = 0;
+	}
+
+	bool valid() const {
+		return header.magic == FUGUE_BUS_MAGIC && header.length <= FUGUE_BUS_CAPACITY;
+	}
+
+	static uint32_t paddedSize(uint32_t length) {
+		return (uint32_t)sizeof(FugueSectionHeader) + ((length + 7u) & ~7u);
+	}
+
+	// Returns false (and leaves the message unchanged) when it doesn't fit
+	bool append(uint16_t type, uint16_t version, uint32_t revision, int64_t origin,
+	            const void* data, uint32_t length) {
+		uint32_t size = paddedSize(length);
+		if (header.length + size > FUGUE_BUS_CAPACITY) return false;
+		FugueSectionHeader* section = (FugueSectionHeader*)(payload + header.length);
+		section->type = type;
+		section->version = version;
+		section->length = length;
+		section->revision = revision;
+		section->origin = origin;
+		std::memcpy(section + 1, data, length);
+		header.length += size;
+		header.numSections++;
+		return true;
+	}
+
+	// Copy a section from another message unchanged (forwarding along the chain)
+	bool forward(const FugueSectionHeader* section) {
+		uint32_t size = paddedSize(section->length);
+		if (header.length + size > FUGUE_BUS_CAPACITY) return false;
+		std::memcpy(payload + header.length, section, size);
+		header.length += size;
+		header.numSections++;
+		return true;
+	}
+
+	const FugueSectionHeader* first() const {
+		return next(nullptr);
+	}
+
+	// Next section after `section` (or the first, given nullptr); nullptr at
+	// the end or on a malformed length
+	const FugueSectionHeader* next(const FugueSectionHeader* section) const {
+		if (!valid()) return nullptr;
+		uint32_t offset = 0;
+		if (section) offset = (uint32_t)((const uint8_t*)section - payload) + paddedSize(section->length);
+		if (offset + sizeof(FugueSectionHeader) > header.length) return nullptr;
+		const FugueSectionHeader* result = (const FugueSectionHeader*)(payload + offset);
+		if (offset + paddedSize(result->length) > header.length) return nullptr;
+		return result;
+	}
+
+	const FugueSectionHeader* find(uint16_t type, const FugueSectionHeader* after = nullptr) const {
+		for (const FugueSectionHeader* s = next(after); s; s = next(s)) {
+			if (s->type == type) return s;
+		}
+		return nullptr;
+	}
+
+	template <typename T>
+	static const T* sectionData(const FugueSectionHeader* section) {
+		return section->length >= sizeof(T) ? (const T*)(section + 1) : nullptr;
+	}
+};
+
+// Writer side of one section: bumps the revision when the payload changes.
+// Payloads must be built from zeroed structs so padding compares equal.
+template <typename T>
+struct FugueSectionWriter {
+	T last;
+	uint32_t revision = 0;
+
+	FugueSectionWriter() {
+		std::memset(&last, 0, sizeof(T));
+	}
+
+	void write(FugueBusMessage& msg, uint16_t type, int64_t origin, const T& value) {
+		if (revision == 0 || std::memcmp(&last, &value, sizeof(T)) != 0) {
+			std::memcpy(&last, &value, sizeof(T));
+			revision++;
+		}
+		msg.append(type, FUGUE_BUS_VERSION, revision, origin, &last, sizeof(T));
+	}
+};
+
+// Reader side of one section: keeps a local copy, refreshed only when the
+// section's origin or revision moves.
+template <typename T>
+struct FugueSectionReader {
+	T value;
+	uint32_t revision = 0;
+	int64_t origin = -1;
+
+	FugueSectionReader() {
+		reset();
+	}
+
+	void reset() {
+		std::memset(&value, 0, sizeof(T));
+		revision = 0;
+		origin = -1;
+	}
+
+	// Returns false if the section is missing
+	bool read(const FugueSectionHeader* section) {
+		if (!section) return false;
+		if (section->origin != origin || section->revision != revision) {
+			uint32_t n = std::min((uint32_t)sizeof(T), section->length);
+			std::memset(&value, 0, sizeof(T));
+			std::memcpy(&value, section + 1, n);
+			origin = section->origin;
+			revision = section->revision;
+		}
+		return true;
+	}
+};
+
+// Modules that speak the bus. Fugue only looks right for expanders; an
+// expander accepts either Fugue or another expander on its left.
+static inline bool isFugueExpander(Module* m) {
+	return m && m->model == modelFugueX;
+}
+
+static inline bool isFugueBusSource(Module* m) {
+	return m && (m->model == modelFugue || m->model == modelFugueX);
+}
+
+// ─── Shared-State Link ───────────────────────────────────────────────────────
+// Fugue → expanders without the bus's one-sample flip. Fugue owns a FugueLink
+// and publishes into it as it processes; expanders find it with fugueLink()
+// and read it directly, so an expander processed after Fugue in a frame sees
+// that frame's state.
+//
+// Voice state is a seqlock: the sequence is odd while Fugue is copying, and a
+// reader that sees it odd or moving keeps its previous copy. Clock edges go
+// into a ring of events stamped with Fugue's frame. Every reader keeps its
+// own cursor, so each edge reaches each expander exactly once, along with
+// how many frames late it is being read.
+
+static const int FUGUE_LINK_EVENTS = 64;   // power of two
+
+struct FugueEdgeEvent {
+	int64_t frame;          // Fugue's frame when the clock rose
+	int voice;              // row, 0..FUGUE_NUM_VOICES-1
+	int step;               // index into the sequence
+	bool gateOn;
+};
+
+struct FugueLink {
+	std::atomic<uint32_t> stateSeq{0};
+	FugueToExpanderMessage state;
+	std::atomic<uint64_t> eventCount{0};   // events published so far
+	FugueEdgeEvent events[FUGUE_LINK_EVENTS];
+	std::atomic<uint32_t> randomizeRequests{0};   // bumped by expanders, taken by Fugue
+
+	FugueLink() {
+		std::memset(&state, 0, sizeof(state));
+		std::memset(events, 0, sizeof(events));
+	}
+
+	// Fugue's side (audio thread)
+	void publishState(const FugueToExpanderMessage& value) {
+		uint32_t seq = stateSeq.load(std::memory_order_relaxed);
+		stateSeq.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		std::memcpy(&state, &value, sizeof(state));
+		stateSeq.store(seq + 2, std::memory_order_release);
+	}
+
+	void publishEdge(const FugueEdgeEvent& event) {
+		uint64_t n = eventCount.load(std::memory_order_relaxed);
+		events[n & (FUGUE_LINK_EVENTS - 1)] = event;
+		eventCount.store(n + 1, std::memory_order_release);
+	}
+};
+
+// Fugue's link for a module in its chain: Fugue itself, or any expander
+// whose left neighbours lead back to it. nullptr when there's no Fugue.
+FugueLink* fugueLink(Module* m);
+
+// Expander's side of the link
+struct FugueLinkReader {
+	FugueLink* link = nullptr;
+	uint64_t cursor = 0;
+	FugueToExpanderMessage state;
+
+	FugueLinkReader() {
+		std::memset(&state, 0, sizeof(state));
+	}
+
+	// Switch links; edges from before attaching aren't replayed
+	void attach(FugueLink* newLink) {
+		if (newLink == link) return;
+		link = newLink;
+		cursor = link ? link->eventCount.load(std::memory_order_acquire) : 0;
+		std::memset(&state, 0, sizeof(state));
+	}
+
+	// Refresh `state`; keeps the last good copy if Fugue is mid-write
+	void readState() {
+		if (!link) return;
+		uint32_t before = link->stateSeq.load(std::memory_order_acquire);
+		if (before & 1) return;
+		FugueToExpanderMessage copy;
+		std::memcpy(&copy, &link->state, sizeof(copy));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (link->stateSeq.load(std::memory_order_relaxed) != before) return;
+		state = copy;
+	}
+
+	// Next undelivered edge; false when caught up. A reader that fell a whole
+	// ring behind skips to the oldest edge that can't be overwritten mid-copy.
+	bool nextEdge(FugueEdgeEvent& event) {
+		if (!link) return false;
+		while (true) {
+			uint64_t count = link->eventCount.load(std::memory_order_acquire);
+			if (cursor >= count) return false;
+			if (count - cursor >= (uint64_t)FUGUE_LINK_EVENTS) cursor = count - FUGUE_LINK_EVENTS + 1;
+			event = link->events[cursor & (FUGUE_LINK_EVENTS - 1)];
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (link->eventCount.load(std::memory_order_relaxed) - cursor < (uint64_t)FUGUE_LINK_EVENTS) {
+				cursor++;
+				return true;
+			}
+			// Overwritten while copying; go again from the new oldest
+		}
+	}
+
+	void requestRandomize() {
+		if (link) link->randomizeRequests.fetch_add(1, std::memory_order_relaxed);
+	}
+};
@@ -1,69 +1,22 @@
 #include "plugin.hpp"
 #include "fugue-messages.hpp"
-
-// ─── Scale Tables ────────────────────────────────────────────────────────────
-// Order mirrors Note's scale list so SCALE CV values are interchangeable
-// between modules. Two extras (Melodic Minor, Locrian) are appended to
-// preserve them from older Fugue versions.
-
-struct ScaleInfo {
-	const float* intervals;
-	int size;
-};
-
-// 12-TET scales (integer semitones, expressed as floats)
-static const float SCALE_CHROMATIC[]   = {0,1,2,3,4,5,6,7,8,9,10,11};
-static const float SCALE_MAJOR[]       = {0,2,4,5,7,9,11};
-static const float SCALE_NAT_MINOR[]   = {0,2,3,5,7,8,10};
-static const float SCALE_PENTA_MAJ[]   = {0,2,4,7,9};
-static const float SCALE_PENTA_MIN[]   = {0,3,5,7,10};
-static const float SCALE_BLUES[]       = {0,3,5,6,7,10};
-static const float SCALE_WHOLE[]       = {0,2,4,6,8,10};
-// Just-intonation harmonics 1..12 (non-12-TET, log2(n)*12)
-static const float SCALE_HARMONIC[]    = {
-	0.f, 12.f, 19.0196f, 24.f, 27.8631f, 31.0196f,
-	33.6883f, 36.f, 38.0392f, 39.8632f, 41.5126f, 43.0196f
-};
-static const float SCALE_DORIAN[]      = {0,2,3,5,7,9,10};
-static const float SCALE_PHRYGIAN[]    = {0,1,3,5,7,8,10};
-static const float SCALE_LYDIAN[]      = {0,2,4,6,7,9,11};
-static const float SCALE_MIXOLYDIAN[]  = {0,2,4,5,7,9,10};
-static const float SCALE_HARM_MINOR[]  = {0,2,3,5,7,8,11};
-static const float SCALE_HIJAZ[]       = {0,1,4,5,7,8,10};
-static const float SCALE_HIRAJOSHI[]   = {0,2,3,7,8};
-// Pelog: Surakarta-style approximation in cents/12 (non-12-TET)
-static const float SCALE_PELOG[]       = {0.f, 1.2f, 2.7f, 5.4f, 7.0f, 8.0f, 10.4f};
-// Slendro: 5 equal divisions of the octave (non-12-TET)
-static const float SCALE_SLENDRO[]     = {0.f, 2.4f, 4.8f, 7.2f, 9.6f};
-// Preserved-from-old-Fugue extras
-static const float SCALE_MELO_MINOR[]  = {0,2,3,5,7,9,11};
-static const float SCALE_LOCRIAN[]     = {0,1,3,5,6,8,10};
-
-static const ScaleInfo SCALES[] = {
-	{SCALE_CHROMATIC, 12},   //  0  Chromatic
-	{SCALE_MAJOR,      7},   //  1  Major
-	{SCALE_NAT_MINOR,  7},   //  2  Minor
-	{SCALE_PENTA_MAJ,  5},   //  3  Pentatonic Major
-	{SCALE_PENTA_MIN,  5},   //  4  Pentatonic Minor
-	{SCALE_BLUES,      6},   //  5  Blues
-	{SCALE_WHOLE,      6},   //  6  Whole tone
-	{SCALE_HARMONIC,  12},   //  7  Harmonic series
-	{SCALE_DORIAN,     7},   //  8  Dorian
-	{SCALE_PHRYGIAN,   7},   //  9  Phrygian
-	{SCALE_LYDIAN,     7},   // 10  Lydian
-	{SCALE_MIXOLYDIAN, 7},   // 11  Mixolydian
-	{SCALE_HARM_MINOR, 7},   // 12  Harmonic Minor
-	{SCALE_HIJAZ,      7},   // 13  Hijaz
-	{SCALE_HIRAJOSHI,  5},   // 14  Hirajoshi
-	{SCALE_PELOG,      7},   // 15  Pelog
-	{SCALE_SLENDRO,    5},   // 16  Slendro
-	{SCALE_MELO_MINOR, 7},   // 17  Melodic Minor (Fugue extra)
-	{SCALE_LOCRIAN,    7},   // 18  Locrian (Fugue extra)
-};
-static const int NUM_SCALES_FUGUE = sizeof(SCALES) / sizeof(SCALES[0]);
-
-static const int NUM_STEPS = 8;
-static const int NUM_VOICES = 3;
+#include "tuning.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+using simd::float_4;
+
+// Scales come from tuning.hpp; Fugue offers the whole built-in list, whose
+// order mirrors Note's so SCALE CV values are interchangeable.
+static const int NUM_SCALES_FUGUE = NUM_BUILTIN_SCALES;
+
+static const int NUM_STEPS = 8;     // faders per page on the panel
+static const int MAX_STEPS = 64;    // sequence length limit
+static const int NUM_PAGES = MAX_STEPS / NUM_STEPS;
+static const int NUM_ROWS = 3;      // panel voice rows A, B, C
+static const int MAX_VOICES = 16;   // voices past the third ride the rows' poly channels
 static const int CHROMATIC_SCALE_INDEX = 0;
 
 // ─── Harmonic Deviation Tier Tables ──────────────────────────────────────────
@@ -124,27 +77,255 @@ static inline float randFloat(uint32_t& state) {
 
 // ─── Interval Consonance Scoring ─────────────────────────────────────────────
 
-static float intervalConsonance(int semitones) {
-	semitones = ((semitones % 12) + 12) % 12;
-	static const float scores[] = {
-		1.0f,   // 0: Unison
-		0.1f,   // 1: m2
-		0.3f,   // 2: M2
-		0.65f,  // 3: m3
-		0.7f,   // 4: M3
-		0.85f,  // 5: P4
-		0.15f,  // 6: tritone
-		0.9f,   // 7: P5
-		0.55f,  // 8: m6
-		0.6f,   // 9: M6
-		0.25f,  // 10: m7
-		0.1f,   // 11: M7
-	};
-	return scores[semitones];
+// Indexed by interval in semitones, mod 12
+static const float CONSONANCE[12] = {
+	1.0f,   // 0: Unison
+	0.1f,   // 1: m2
+	0.3f,   // 2: M2
+	0.65f,  // 3: m3
+	0.7f,   // 4: M3
+	0.85f,  // 5: P4
+	0.15f,  // 6: tritone
+	0.9f,   // 7: P5
+	0.55f,  // 8: m6
+	0.6f,   // 9: M6
+	0.25f,  // 10: m7
+	0.1f,   // 11: M7
+};
+
+// Harmonic Lock works at quarter-tone resolution so the non-12-TET scales
+// (Pelog, Slendro, Harmonic) score between their neighbouring semitones
+// instead of snapping onto one. Row p of the table is the consonance of every
+// pitch class against a voice sounding class p; summing the other voices'
+// rows gives a field that scores any number of candidates by lookup.
+
+static const int LOCK_CLASSES = 24;
+static const int LOCK_CANDIDATES = 32;
+// Default Lock strength: the 3 candidates Harmonic Lock always weighed, so
+// patches from before the slider existed pick the same notes
+static const float LOCK_DEFAULT_STRENGTH = 2.f / (LOCK_CANDIDATES - 1);
+static const int LOOKAHEAD_STEPS = 64;
+static const int PREVIEW_STEPS = 8;
+static const int HISTORY_LENGTH = 64;
+
+struct LockTable {
+	alignas(16) float rows[LOCK_CLASSES][LOCK_CLASSES];
+
+	LockTable() {
+		float cons[LOCK_CLASSES];
+		for (int i = 0; i < LOCK_CLASSES; i++) {
+			// A quarter tone is rougher than either semitone it falls between
+			if (i % 2 == 0) cons[i] = CONSONANCE[i / 2];
+			else cons[i] = 0.5f * std::min(CONSONANCE[i / 2], CONSONANCE[(i / 2 + 1) % 12]);
+		}
+		for (int p = 0; p < LOCK_CLASSES; p++) {
+			for (int q = 0; q < LOCK_CLASSES; q++) {
+				rows[p][q] = cons[(q - p + LOCK_CLASSES) % LOCK_CLASSES];
+			}
+		}
+	}
+};
+
+static const LockTable& lockTable() {
+	static const LockTable table;
+	return table;
 }
 
+static inline int lockClass(float volts) {
+	int q = (int)std::floor(volts * (float)LOCK_CLASSES + 0.5f) % LOCK_CLASSES;
+	return q < 0 ? q + LOCK_CLASSES : q;
+}
+
+// ─── Scale Quantizer ─────────────────────────────────────────────────────────
+// Lookup table for one (tuning, root, range) combination. The sorted note list
+// plus a bucket index turn fader → nearest note into a couple of comparisons;
+// degree lookups go through the tuning's own tables. Rebuilt only when the key
+// changes, so steady-state clocking never rescans.
+
+struct ScaleQuantizer {
+	// Every degree of the largest Scala tuning over the widest fader range
+	// (5V) and then some: TUNING_MAX_DEGREES per period for 8 periods. Only
+	// a tuning whose period is well under an octave can be denser; it keeps
+	// its lowest MAX_NOTES notes.
+	static const int MAX_NOTES = TUNING_MAX_DEGREES * 8;
+	static const int NUM_BUCKETS = MAX_NOTES;
+
+	std::shared_ptr<const Tuning> tuning;   // held, so a replaced Scala tuning outlives the table
+	uint32_t serial = 0;
+	int rootNote = -1;
+	float range = -1.f;
+
+	float notes[MAX_NOTES];              // tuning notes in [0, range], volts above root
+	int numNotes = 0;
+	uint16_t bucketStart[NUM_BUCKETS];   // last note at or below each bucket's lower edge
+
+	void update(const std::shared_ptr<const Tuning>& newTuning, int newRoot, float newRange) {
+		if (tuning != newTuning) tuning = newTuning;
+		if (newTuning->serial == serial && newRoot == rootNote && newRange == range) return;
+		serial = newTuning->serial;
+		rootNote = newRoot;
+		range = newRange;
+
+		int maxOctaves = (int)(range * 12.f / tuning->period) + 3;
+		numNotes = 0;
+		for (int oct = 0; oct <= maxOctaves; oct++) {
+			for (int d = 0; d < tuning->size; d++) {
+				float noteVoltage = tuning->semitones(oct * tuning->size + d) / 12.f;
+				if (noteVoltage > range + 0.05f) break;
+				if (noteVoltage < -0.05f) continue;
+				if (numNotes < MAX_NOTES) notes[numNotes++] = noteVoltage;
+			}
+		}
+
+		// Harmonic series spans several octaves per pass, so sort and dedupe
+		std::sort(notes, notes + numNotes);
+		numNotes = (int)(std::unique(notes, notes + numNotes) - notes);
+
+		int n = 0;
+		for (int b = 0; b < NUM_BUCKETS; b++) {
+			float edge = (float)b / NUM_BUCKETS * range;
+			while (n + 1 < numNotes && notes[n + 1] <= edge) n++;
+			bucketStart[b] = (uint16_t)n;
+		}
+	}
+
+	// Root plus the tuning's reference offset, in volts
+	float rootVolts() const {
+		return ((float)rootNote + tuning->offset) / 12.f;
+	}
+
+	float quantize(float faderValue) const {
+		if (numNotes == 0) return rootVolts();
+
+		faderValue = clamp(faderValue, 0.f, 1.f);
+		float rawVoltage = faderValue * range;
+		int b = std::min((int)(faderValue * NUM_BUCKETS), NUM_BUCKETS - 1);
+		int n = bucketStart[b];
+		while (n + 1 < numNotes && notes[n + 1] <= rawVoltage) n++;
+
+		float best = notes[n];
+		if (n + 1 < numNotes && notes[n + 1] - rawVoltage < std::abs(rawVoltage - best))
+			best = notes[n + 1];
+		return best + rootVolts();
+	}
+};
+
+// ─── Learned Deviation Model ─────────────────────────────────────────────────
+// Interval transitions learned from a V/Oct melody: counts[a][b] is how often
+// an interval of a semitones was followed by one of b (both clamped to an
+// octave either way). Each row keeps an alias table (Vose's method), so a
+// draw is one random number and one comparison. Learning bumps a count and
+// rebuilds that row's table in place; nothing allocates. The last row pools
+// every transition and stands in for rows with no data yet.
+
+static const int MARKOV_SPAN = 12;
+static const int MARKOV_CLASSES = 2 * MARKOV_SPAN + 1;   // intervals -12..+12
+static const int MARKOV_POOLED = MARKOV_CLASSES;          // row index of the pooled row
+
+struct MarkovModel {
+	uint16_t counts[MARKOV_CLASSES + 1][MARKOV_CLASSES];
+	uint32_t rowTotal[MARKOV_CLASSES + 1];
+	float aliasProb[MARKOV_CLASSES + 1][MARKOV_CLASSES];
+	uint8_t alias[MARKOV_CLASSES + 1][MARKOV_CLASSES];
+	uint32_t revision = 0;    // bumped on every change, for look-ahead validation
+
+	MarkovModel() {
+		clear();
+	}
+
+	void clear() {
+		std::memset(counts, 0, sizeof(counts));
+		for (int r = 0; r <= MARKOV_CLASSES; r++) rebuildRow(r);
+		revision++;
+	}
+
+	static int intervalClass(int semis) {
+		return clamp(semis, -MARKOV_SPAN, MARKOV_SPAN) + MARKOV_SPAN;
+	}
+
+	uint32_t transitions() const {
+		return rowTotal[MARKOV_POOLED];
+	}
+
+	void learn(int previousInterval, int interval) {
+		int a = intervalClass(previousInterval);
+		int b = intervalClass(interval);
+		addCount(a, b);
+		addCount(MARKOV_POOLED, b);
+		rebuildRow(a);
+		rebuildRow(MARKOV_POOLED);
+		revision++;
+	}
+
+	// Halve a saturated row so recent material keeps its say
+	void addCount(int row, int b) {
+		if (counts[row][b] == UINT16_MAX) {
+			for (int k = 0; k < MARKOV_CLASSES; k++) counts[row][k] /= 2;
+		}
+		counts[row][b]++;
+	}
+
+	void rebuildRow(int row) {
+		uint32_t total = 0;
+		for (int k = 0; k < MARKOV_CLASSES; k++) total += counts[row][k];
+		rowTotal[row] = total;
+		if (total == 0) return;
+
+		float scaled[MARKOV_CLASSES];
+		int small[MARKOV_CLASSES], large[MARKOV_CLASSES];
+		int numSmall = 0, numLarge = 0;
+		for (int k = 0; k < MARKOV_CLASSES; k++) {
+			scaled[k] = (float)counts[row][k] * MARKOV_CLASSES / (float)total;
+			if (scaled[k] < 1.f) small[numSmall++] = k;
+			else large[numLarge++] = k;
+		}
+		while (numSmall > 0 && numLarge > 0) {
+			int s = small[--numSmall];
+			int l = large[--numLarge];
+			aliasProb[row][s] = scaled[s];
+			alias[row][s] = (uint8_t)l;
+			scaled[l] -= 1.f - scaled[s];
+			if (scaled[l] < 1.f) small[numSmall++] = l;
+			else large[numLarge++] = l;
+		}
+		// Leftovers are 1 up to rounding
+		while (numLarge > 0) {
+			int l = large[--numLarge];
+			aliasProb[row][l] = 1.f;
+			alias[row][l] = (uint8_t)l;
+		}
+		while (numSmall > 0) {
+			int s = small[--numSmall];
+			aliasProb[row][s] = 1.f;
+			alias[row][s] = (uint8_t)s;
+		}
+	}
+
+	// Draw the interval that follows `previousInterval`; false while untrained
+	bool sample(int previousInterval, uint32_t& rng, int& interval) const {
+		int row = intervalClass(previousInterval);
+		if (rowTotal[row] == 0) row = MARKOV_POOLED;
+		if (rowTotal[row] == 0) return false;
+		float u = randFloat(rng) * MARKOV_CLASSES;
+		int k = std::min((int)u, MARKOV_CLASSES - 1);
+		if (u - (float)k >= aliasProb[row][k]) k = alias[row][k];
+		interval = k - MARKOV_SPAN;
+		return true;
+	}
+};
+
 // ─── Custom ParamQuantity for fader note display ────────────────────────────
 
+// Convert voltage to note name (0V = C4 in 1V/oct standard)
+static std::string voltageToNoteName(float voltage) {
+	static const char* noteNames[] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+	int totalSemitones = (int)std::round(voltage * 12.f);
+	int octave = 4 + (int)std::floor((float)totalSemitones / 12.f);
+	int noteIdx = ((totalSemitones % 12) + 12) % 12;
+
+	return string::f("%s%d", noteNames[noteIdx], octave);
+}
+
 struct Fugue;
 
 struct FaderParamQuantity : ParamQuantity {
@@ -173,7 +354,9 @@ struct Fugue : Module {
 		WANDER_C_PARAM,
 		RESET_BUTTON_PARAM,
 		GATE_TOGGLE_PARAM_0,   // 24 toggles: step0_A, step0_B, step0_C, step1_A, ...
-		PARAMS_LEN = GATE_TOGGLE_PARAM_0 + NUM_STEPS * NUM_VOICES
+		LOCK_STRENGTH_PARAM = GATE_TOGGLE_PARAM_0 + NUM_STEPS * NUM_ROWS,
+		PAGE_PARAM,
+		PARAMS_LEN
 	};
 
 	enum InputId {
@@ -203,60 +386,144 @@ struct Fugue : Module {
 
 	enum LightId {
 		GATE_LIGHT_0,         // 24 gate toggle LEDs
-		STEP_A_LIGHT_0 = GATE_LIGHT_0 + NUM_STEPS * NUM_VOICES,
+		STEP_A_LIGHT_0 = GATE_LIGHT_0 + NUM_STEPS * NUM_ROWS,
 		STEP_B_LIGHT_0 = STEP_A_LIGHT_0 + NUM_STEPS,
 		STEP_C_LIGHT_0 = STEP_B_LIGHT_0 + NUM_STEPS,
 		LIGHTS_LEN = STEP_C_LIGHT_0 + NUM_STEPS
 	};
 
-	// ─── Per-voice state ─────────────────────────────────────────────────────
-
-	struct VoiceState {
-		int currentStep = 0;
-		float clockPeriod = 0.5f;
-		float clockTimer = 0.f;
-		bool clockHigh = false;
-		uint32_t stepCounter = 0;
-		dsp::SchmittTrigger clockTrigger;
-
-		float currentVoltage = 0.f;
-		float targetVoltage = 0.f;
-		float slewRate = 0.f;
+	// ─── Per-voice state ────────────────────────────────────────────────────
+	// Structure of arrays, one lane per voice, so consonance scoring can sweep
+	// the voices four at a time. Voice v belongs to row v % 3 (its gate
+	// toggles, wander slider and jacks) and sits on that row's poly channel
+	// v / 3, so the classic three voices are channel 0 of rows A, B and C.
+
+	struct VoiceBank {
+		int currentStep[MAX_VOICES] = {};
+		float clockPeriod[MAX_VOICES];
+		float clockTimer[MAX_VOICES] = {};
+		bool clockHigh[MAX_VOICES] = {};
+		uint32_t stepCounter[MAX_VOICES] = {};
+		dsp::SchmittTrigger clockTrigger[MAX_VOICES];
+
+		alignas(16) float currentVoltage[MAX_VOICES] = {};
+		alignas(16) float targetVoltage[MAX_VOICES] = {};
+		float slewRate[MAX_VOICES] = {};
 		// True between Reset and the first clock pulse — makes that first
 		// clock fire step 0 (visually step 1) instead of incrementing past
 		// it to step 1 (visually step 2).
-		bool firstClockPending = true;
+		bool firstClockPending[MAX_VOICES];
+
+		VoiceBank() {
+			for (int v = 0; v < MAX_VOICES; v++) {
+				clockPeriod[v] = 0.5f;
+				firstClockPending[v] = true;
+			}
+		}
 	};
 
-	VoiceState voices[NUM_VOICES];
+	VoiceBank voices;
+	int numVoices = NUM_ROWS;      // 3..16, set from the context menu
+	int activeVoices = NUM_ROWS;   // numVoices as of the last process() call
+	int voiceStepCounts[MAX_VOICES];  // step count after FugueX overrides
+	float voiceRanges[MAX_VOICES];    // fader range after FugueX overrides
+	// Per voice, since FugueX can give each voice its own fader range
+	ScaleQuantizer quantizers[MAX_VOICES];
 	dsp::SchmittTrigger resetTrigger;
 	dsp::SchmittTrigger resetButtonTrigger;
 	float faderRangeVolts = 1.f;
 	bool harmonicLock = true;
+	// Scala tuning; while in use it replaces the SCALE knob's selection
+	TuningLoader scalaTuning;
+	TuningRef scalaRef;              // audio thread's hold on scalaTuning
+	bool useScalaTuning = false;
+
+	// Learned deviation model, trained on voice 1's clock from the Root CV
+	// jack while learning is on (the jack then stops transposing)
+	MarkovModel markov;
+	bool learnedDeviation = false;
+	bool learnFromRootCv = false;
+	int learnLastNote = 0;
+	int learnLastInterval = 0;
+	int learnHeld = 0;              // notes seen since learning started, up to 2
+	std::atomic<bool> markovClearWanted{false};   // set from the context menu
 
 	// ─── Expander state ─────────────────────────────────────────────────────
-	int sleepCounter[NUM_VOICES] = {};       // clocks remaining in sleep
-	bool sleeping[NUM_VOICES] = {};          // voice is in sleep state
+	int sleepCounter[MAX_VOICES] = {};       // clocks remaining in sleep
+	bool sleeping[MAX_VOICES] = {};          // voice is in sleep state
 	bool sampleHoldEnabled = false;
-	bool sampleHoldHolding[NUM_VOICES] = {}; // currently holding CV
-	bool probGateSuppress[NUM_VOICES] = {};  // gate suppressed by probability
+	bool sampleHoldHolding[MAX_VOICES] = {}; // currently holding CV
+	bool probGateSuppress[MAX_VOICES] = {};  // gate suppressed by probability
 	uint32_t probRng = 12345;
+	ExpanderToFugueMessage defaultOverrides;
+	FugueSectionReader<ExpanderToFugueMessage> overrideReader;
+	FugueLink link;                          // voice state and clock edges for expanders
+	std::atomic<bool> randomizeWanted{false};   // set from the context menu
+
+	// ─── Sequence ───────────────────────────────────────────────────────────
+	// The sequence lives here, up to 64 steps; the 8 faders and 24 gate
+	// toggles are a window onto one page of it. Panel edits are copied in
+	// each sample, and a page change copies the page back out to the panel.
+
+	struct Sequence {
+		float pitch[MAX_STEPS];
+		uint8_t gates[MAX_STEPS];   // bit r = row r's gate toggle
+
+		Sequence() {
+			for (int i = 0; i < MAX_STEPS; i++) {
+				pitch[i] = 0.f;
+				gates[i] = (1 << NUM_ROWS) - 1;
+			}
+		}
+
+		bool gate(int step, int row) const {
+			return (gates[step] >> row) & 1;
+		}
+	};
+
+	Sequence sequence;
+	int shownPage = -1;             // page on the panel, -1 = adopt the panel as is
+	float shownPitch[NUM_STEPS];
+	uint8_t shownGates[NUM_STEPS];
+	uint32_t gatesRevision = 0;     // bumped on any gate edit
+	bool followPlayhead = false;
+
+	// Distance from each step to the voice's next gated step, so the slew
+	// lookup on a clock edge doesn't scan the sequence. Rebuilt when the
+	// gates or the voice's step count change.
+	uint8_t gateDistance[MAX_VOICES][MAX_STEPS];
+	uint32_t gateDistanceRevision[MAX_VOICES];
+	int gateDistanceSteps[MAX_VOICES] = {};
 
 	// ─── Constructor ─────────────────────────────────────────────────────────
 
 	~Fugue() {
-		delete (FugueToExpanderMessage*)rightExpander.producerMessage;
-		delete (FugueToExpanderMessage*)rightExpander.consumerMessage;
+		stopLookahead();
 	}
 
 	Fugue() {
 		config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
 
-		// Expander message buffers (Fugue → FugueX)
-		rightExpander.producerMessage = new FugueToExpanderMessage();
-		rightExpander.consumerMessage = new FugueToExpanderMessage();
+		for (int v = 0; v < MAX_VOICES; v++) {
+			voiceStepCounts[v] = NUM_STEPS;
+			gateDistanceRevision[v] = ~0u;
+			voiceRanges[v] = faderRangeVolts;
+			historyCount[v].store(0);
+			phrasePos[v] = -1;
+		}
+		startLookahead();
+
+		// Overrides used when no expander is attached
+		std::memset(&defaultOverrides, 0, sizeof(defaultOverrides));
+		for (int r = 0; r < NUM_ROWS; r++) {
+			defaultOverrides.voices[r].stepsOverride = -1;
+			defaultOverrides.voices[r].rangeOverride = -1.f;
+			defaultOverrides.voices[r].sleepDivision = 0;   // 0 = no sleep
+			defaultOverrides.voices[r].probability = 1.f;
+		}
 
-		// 8 pitch faders (custom ParamQuantity shows quantized note name)
+		// 8 pitch faders, editing the page shown (custom ParamQuantity shows
+		// quantized note name)
 		for (int i = 0; i < NUM_STEPS; i++) {
 			configParam<FaderParamQuantity>(FADER_PARAM_0 + i, 0.f, 1.f, 0.f,
 				string::f("Step %d Pitch", i + 1));
@@ -266,23 +533,14 @@ struct Fugue : Module {
 		configSwitch(ROOT_PARAM, 0.f, 11.f, 0.f, "Root Note",
 			{"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"});
 
-		// Scale (snapped) — order matches Note module's SCALES array so
+		// Scale (snapped) — the shared built-in list, in Note's order so
 		// SCALE CV values are interchangeable between modules.
-		configSwitch(SCALE_PARAM, 0.f, (float)(NUM_SCALES_FUGUE - 1), 1.f, "Scale", {
-			"Chromatic", "Major", "Minor",
-			"Pentatonic Major", "Pentatonic Minor",
-			"Blues", "Whole tone", "Harmonic series",
-			"Dorian", "Phrygian", "Lydian", "Mixolydian",
-			"Harmonic Minor", "Hijaz (Arabic)",
-			"Hirajoshi (Japanese)",
-			"Pelog (Gamelan, 7-tone)",
-			"Slendro (Gamelan, 5-equal)",
-			"Melodic Minor", "Locrian"
-		});
+		configSwitch(SCALE_PARAM, 0.f, (float)(NUM_SCALES_FUGUE - 1), 1.f, "Scale",
+			builtinScaleLabels(NUM_SCALES_FUGUE));
 
 		// Steps (snapped)
-		configSwitch(STEPS_PARAM, 1.f, 8.f, 8.f, "Steps",
-			{"1", "2", "3", "4", "5", "6", "7", "8"});
+		configParam(STEPS_PARAM, 1.f, (float)MAX_STEPS, 8.f, "Steps");
+		paramQuantities[STEPS_PARAM]->snapEnabled = true;
 
 		// Slew
 		configParam(SLEW_PARAM, 0.f, 1.f, 0.f, "Slew", "%", 0.f, 100.f);
@@ -298,8 +556,8 @@ struct Fugue : Module {
 		// 24 gate toggle buttons (default: A all on, B and C all off)
 		const char* voiceNames[] = {"A", "B", "C"};
 		for (int step = 0; step < NUM_STEPS; step++) {
-			for (int v = 0; v < NUM_VOICES; v++) {
-				int idx = step * NUM_VOICES + v;
+			for (int v = 0; v < NUM_ROWS; v++) {
+				int idx = step * NUM_ROWS + v;
 				float defaultVal = 1.f;
 				configSwitch(GATE_TOGGLE_PARAM_0 + idx, 0.f, 1.f, defaultVal,
 					string::f("Gate %s Step %d", voiceNames[v], step + 1),
@@ -307,6 +565,17 @@ struct Fugue : Module {
 			}
 		}
 
+		// Harmonic Lock strength (menu slider, no panel control)
+		configParam(LOCK_STRENGTH_PARAM, 0.f, 1.f, LOCK_DEFAULT_STRENGTH, "Lock strength", "%", 0.f, 100.f);
+
+		// Page of the sequence on the faders (context menu, no panel control)
+		std::vector<std::string> pageLabels;
+		for (int p = 0; p < NUM_PAGES; p++) {
+			pageLabels.push_back(string::f("Steps %d-%d", p * NUM_STEPS + 1, (p + 1) * NUM_STEPS));
+		}
+		configSwitch(PAGE_PARAM, 0.f, (float)(NUM_PAGES - 1), 0.f, "Page", pageLabels);
+		paramQuantities[PAGE_PARAM]->randomizeEnabled = false;
+
 		// Inputs
 		configInput(CLOCK_A_INPUT, "Clock A");
 		configInput(CLOCK_B_INPUT, "Clock B (normalled to A)");
@@ -329,12 +598,72 @@ struct Fugue : Module {
 		configOutput(GATE_C_OUTPUT, "Gate C");
 	}
 
+	void onReset() override {
+		// Params are back at their defaults; clear the pages they don't show
+		sequence = Sequence();
+		shownPage = -1;
+		followPlayhead = false;
+		learnedDeviation = false;
+		learnFromRootCv = false;
+		learnHeld = 0;
+		markovClearWanted = true;
+	}
+
 	// ─── JSON Persistence ────────────────────────────────────────────────────
 
 	json_t* dataToJson() override {
 		json_t* rootJ = json_object();
 		json_object_set_new(rootJ, "faderRange", json_real(faderRangeVolts));
 		json_object_set_new(rootJ, "harmonicLock", json_boolean(harmonicLock));
+		json_object_set_new(rootJ, "numVoices", json_integer(numVoices));
+		json_t* pitchesJ = json_array();
+		json_t* gatesJ = json_array();
+		for (int i = 0; i < MAX_STEPS; i++) {
+			json_array_append_new(pitchesJ, json_real(sequence.pitch[i]));
+			json_array_append_new(gatesJ, json_integer(sequence.gates[i]));
+		}
+		json_t* sequenceJ = json_object();
+		json_object_set_new(sequenceJ, "pitches", pitchesJ);
+		json_object_set_new(sequenceJ, "gates", gatesJ);
+		json_object_set_new(rootJ, "sequence", sequenceJ);
+		json_object_set_new(rootJ, "followPlayhead", json_boolean(followPlayhead));
+		if (!scalaTuning.sclPath.empty()) {
+			json_object_set_new(rootJ, "sclPath", json_string(scalaTuning.sclPath.c_str()));
+			if (!scalaTuning.kbmPath.empty())
+				json_object_set_new(rootJ, "kbmPath", json_string(scalaTuning.kbmPath.c_str()));
+		}
+		json_object_set_new(rootJ, "useScalaTuning", json_boolean(useScalaTuning));
+		json_object_set_new(rootJ, "learnedDeviation", json_boolean(learnedDeviation));
+		json_object_set_new(rootJ, "learnFromRootCv", json_boolean(learnFromRootCv));
+		if (markov.transitions() > 0) {
+			// Row-major counts, pooled row last
+			json_t* countsJ = json_array();
+			for (int a = 0; a <= MARKOV_CLASSES; a++) {
+				for (int b = 0; b < MARKOV_CLASSES; b++) {
+					json_array_append_new(countsJ, json_integer(markov.counts[a][b]));
+				}
+			}
+			json_object_set_new(rootJ, "markov", countsJ);
+		}
+		if (phrase.length > 0) {
+			json_t* phraseJ = json_object();
+			json_object_set_new(phraseJ, "length", json_integer(phrase.length));
+			json_t* voicesJ = json_array();
+			for (int v = 0; v < phrase.numVoices; v++) {
+				json_t* notesJ = json_array();
+				json_t* gatesJ = json_array();
+				for (int i = 0; i < phrase.length; i++) {
+					json_array_append_new(notesJ, json_real(phrase.notes[v][i]));
+					json_array_append_new(gatesJ, json_boolean(phrase.gates[v][i]));
+				}
+				json_t* voiceJ = json_object();
+				json_object_set_new(voiceJ, "notes", notesJ);
+				json_object_set_new(voiceJ, "gates", gatesJ);
+				json_array_append_new(voicesJ, voiceJ);
+			}
+			json_object_set_new(phraseJ, "voices", voicesJ);
+			json_object_set_new(rootJ, "phrase", phraseJ);
+		}
 		// Bump on any change to SCALE ordering so dataFromJson can migrate
 		// older saved scaleParam values.
 		json_object_set_new(rootJ, "schemaVersion", json_integer(2));
@@ -346,6 +675,75 @@ struct Fugue : Module {
 		if (j) faderRangeVolts = json_number_value(j);
 		json_t* hlJ = json_object_get(rootJ, "harmonicLock");
 		if (hlJ) harmonicLock = json_boolean_value(hlJ);
+		json_t* nvJ = json_object_get(rootJ, "numVoices");
+		if (nvJ) numVoices = clamp((int)json_integer_value(nvJ), NUM_ROWS, MAX_VOICES);
+
+		// Patches from before paging have no sequence; the panel's 8 steps
+		// are adopted as page 1 on the next sample
+		sequence = Sequence();
+		json_t* sequenceJ = json_object_get(rootJ, "sequence");
+		if (sequenceJ) {
+			json_t* pitchesJ = json_object_get(sequenceJ, "pitches");
+			json_t* gatesJ = json_object_get(sequenceJ, "gates");
+			for (int i = 0; i < MAX_STEPS; i++) {
+				json_t* pitchJ = pitchesJ ? json_array_get(pitchesJ, i) : nullptr;
+				json_t* gateJ = gatesJ ? json_array_get(gatesJ, i) : nullptr;
+				if (pitchJ) sequence.pitch[i] = clamp((float)json_number_value(pitchJ), 0.f, 1.f);
+				if (gateJ) sequence.gates[i] = (uint8_t)(json_integer_value(gateJ) & ((1 << NUM_ROWS) - 1));
+			}
+		}
+		shownPage = -1;
+		gatesRevision++;
+		json_t* followJ = json_object_get(rootJ, "followPlayhead");
+		if (followJ) followPlayhead = json_boolean_value(followJ);
+		json_t* sclJ = json_object_get(rootJ, "sclPath");
+		json_t* kbmJ = json_object_get(rootJ, "kbmPath");
+		if (sclJ) scalaTuning.load(json_string_value(sclJ), kbmJ ? json_string_value(kbmJ) : "");
+		json_t* useScalaJ = json_object_get(rootJ, "useScalaTuning");
+		if (useScalaJ) useScalaTuning = json_boolean_value(useScalaJ);
+		json_t* learnedJ = json_object_get(rootJ, "learnedDeviation");
+		if (learnedJ) learnedDeviation = json_boolean_value(learnedJ);
+		json_t* learnJ = json_object_get(rootJ, "learnFromRootCv");
+		if (learnJ) learnFromRootCv = json_boolean_value(learnJ);
+		learnHeld = 0;
+		markov.clear();
+		json_t* markovJ = json_object_get(rootJ, "markov");
+		if (markovJ && json_array_size(markovJ) == (size_t)((MARKOV_CLASSES + 1) * MARKOV_CLASSES)) {
+			for (int a = 0; a <= MARKOV_CLASSES; a++) {
+				for (int b = 0; b < MARKOV_CLASSES; b++) {
+					int n = (int)json_integer_value(json_array_get(markovJ, a * MARKOV_CLASSES + b));
+					markov.counts[a][b] = (uint16_t)clamp(n, 0, (int)UINT16_MAX);
+				}
+				markov.rebuildRow(a);
+			}
+		}
+
+		// Frozen phrase goes through the same hand-off as a GUI freeze
+		json_t* phraseJ = json_object_get(rootJ, "phrase");
+		pendingPhrase.length = 0;
+		pendingPhrase.numVoices = 0;
+		if (phraseJ) {
+			json_t* lengthJ = json_object_get(phraseJ, "length");
+			json_t* voicesJ = json_object_get(phraseJ, "voices");
+			int length = lengthJ ? (int)json_integer_value(lengthJ) : 0;
+			if (voicesJ && length > 0 && length <= HISTORY_LENGTH) {
+				int count = std::min((int)json_array_size(voicesJ), MAX_VOICES);
+				for (int v = 0; v < count; v++) {
+					json_t* voiceJ = json_array_get(voicesJ, v);
+					json_t* notesJ = json_object_get(voiceJ, "notes");
+					json_t* gatesJ = json_object_get(voiceJ, "gates");
+					for (int i = 0; i < length; i++) {
+						json_t* noteJ = notesJ ? json_array_get(notesJ, i) : nullptr;
+						json_t* gateJ = gatesJ ? json_array_get(gatesJ, i) : nullptr;
+						pendingPhrase.notes[v][i] = noteJ ? (float)json_number_value(noteJ) : 0.f;
+						pendingPhrase.gates[v][i] = gateJ && json_boolean_value(gateJ);
+					}
+				}
+				pendingPhrase.length = length;
+				pendingPhrase.numVoices = count;
+			}
+		}
+		phrasePending.store(true);
 
 		// Schema v1 → v2: SCALE ordering changed to match Note. Remap the
 		// saved scale param so the patch sounds the same as before.
@@ -374,49 +772,45 @@ struct Fugue : Module {
 		}
 	}
 
-	// ─── Scale Quantization ──────────────────────────────────────────────────
-
-	float faderToVoltage(float faderValue, int rootNote, int scaleIndex, float faderRange) {
-		float rawVoltage = faderValue * faderRange;
-		const ScaleInfo& scale = SCALES[scaleIndex];
-
-		float bestVoltage = 0.f;
-		float bestDist = 999.f;
-
-		int maxSemitones = (int)(faderRange * 12.f) + 12;
-		int maxOctaves = maxSemitones / 12 + 2;
+	// ─── Tuning ──────────────────────────────────────────────────────────────
 
-		for (int oct = 0; oct <= maxOctaves; oct++) {
-			for (int d = 0; d < scale.size; d++) {
-				float semitone = (float)(oct * 12) + scale.intervals[d];
-				float noteVoltage = semitone / 12.f;
-
-				if (noteVoltage > faderRange + 0.05f) break;
-				if (noteVoltage < -0.05f) continue;
-
-				float dist = std::abs(noteVoltage - rawVoltage);
-				if (dist < bestDist) {
-					bestDist = dist;
-					bestVoltage = noteVoltage;
-				}
-			}
-		}
+	static std::shared_ptr<const Tuning> pickTuning(const std::shared_ptr<const Tuning>& scala,
+	                                                bool useScala, int scaleIndex) {
+		if (useScala && scala) return scala;
+		return builtinTuningPtr(clamp(scaleIndex, 0, NUM_SCALES_FUGUE - 1));
+	}
 
-		return bestVoltage + (float)rootNote / 12.f;
+	// Audio thread; elsewhere use pickTuning() with scalaTuning.get()
+	std::shared_ptr<const Tuning> activeTuning(int scaleIndex) {
+		return pickTuning(scalaRef.refresh(scalaTuning), useScalaTuning, scaleIndex);
 	}
 
 	// ─── Harmonic Deviation ──────────────────────────────────────────────────
 
-	float selectDeviationNote(float baseVoltage, float stability, int rootNote,
-	                          int scaleIndex, float faderRange, uint32_t seed) {
+	// `model` is the learned model when that mode is on (else nullptr), and
+	// `context` the written interval into this step that it conditions on
+	static float selectDeviationNote(float baseVoltage, float stability,
+	                          const ScaleQuantizer& quant, uint32_t seed,
+	                          const MarkovModel* model, int context) {
 		uint32_t rng = seed;
+		const Tuning& tuning = *quant.tuning;
+		float faderRange = quant.range;
 
 		// At full stability, always return the base note
 		if (stability >= 0.999f) return baseVoltage;
 
 		float tierRoll = randFloat(rng);
 
-		if (scaleIndex == CHROMATIC_SCALE_INDEX) {
+		// ── Learned mode: interval drawn from the model, snapped to the scale ──
+		int interval;
+		if (model && model->sample(context, rng, interval)) {
+			if (tierRoll < stability) return baseVoltage;
+			float semis = (baseVoltage - quant.rootVolts()) * 12.f + (float)interval;
+			float dev = quant.rootVolts() + tuning.semitones(tuning.nearestIndex(semis)) / 12.f;
+			return clamp(dev, baseVoltage - faderRange, baseVoltage + faderRange);
+		}
+
+		if (tuning.builtinIndex == CHROMATIC_SCALE_INDEX) {
 			// ── Chromatic mode: interval-based hierarchy ──
 			float p0 = stability + (1.f - stability) * 0.05f;
 			float p1 = p0 + (1.f - stability) * 0.15f;
@@ -442,8 +836,7 @@ struct Fugue : Module {
 		}
 		else {
 			// ── Diatonic / Pentatonic mode: scale-degree-based ──
-			const ScaleInfo& scale = SCALES[scaleIndex];
-			bool isPenta = (scale.size == 5);
+			bool isPenta = (tuning.size == 5);
 			const DeviationTier* tiers = isPenta ? PENTATONIC_TIERS : DIATONIC_TIERS;
 			int numTiers = isPenta ? NUM_PENTATONIC_TIERS : NUM_DIATONIC_TIERS;
 			// Build cumulative probability thresholds
@@ -475,45 +868,14 @@ struct Fugue : Module {
 				int idx = (int)(randFloat(rng) * tier.count) % tier.count;
 				int scaleDegreeOffset = tier.offsets[idx];
 
-				// Find the base note's scale degree
-				float baseSemiFromRoot = (baseVoltage - (float)rootNote / 12.f) * 12.f;
-				int baseSemiNorm = ((int)std::round(baseSemiFromRoot)) % 12;
-				if (baseSemiNorm < 0) baseSemiNorm += 12;
-				int baseOctave = (int)std::floor(baseSemiFromRoot / 12.f);
-
-				// Find scale degree closest to baseSemiNorm. Floats are used
-				// so non-12-TET scales (Pelog, Slendro, Harmonic) work too.
-				int baseDegree = 0;
-				float bestDiff = 999.f;
-				for (int d = 0; d < scale.size; d++) {
-					float diff = std::fabs(scale.intervals[d] - (float)baseSemiNorm);
-					if (diff < bestDiff) {
-						bestDiff = diff;
-						baseDegree = d;
-					}
-				}
-
-				// Calculate target degree (up or down)
+				// Find the base note's degree, then step up or down from it
+				float baseSemiFromRoot = (baseVoltage - quant.rootVolts()) * 12.f;
+				int baseIndex = tuning.nearestIndex(baseSemiFromRoot);
 				bool goDown = (randFloat(rng) < 0.4f);
-				int targetDegree, targetOctave;
-
-				if (goDown) {
-					int raw = baseDegree - scaleDegreeOffset;
-					if (raw < 0) {
-						targetOctave = baseOctave - 1;
-						targetDegree = ((raw % scale.size) + scale.size) % scale.size;
-					} else {
-						targetOctave = baseOctave;
-						targetDegree = raw;
-					}
-				} else {
-					int raw = baseDegree + scaleDegreeOffset;
-					targetOctave = baseOctave + raw / scale.size;
-					targetDegree = raw % scale.size;
-				}
+				int targetIndex = goDown ? baseIndex - scaleDegreeOffset : baseIndex + scaleDegreeOffset;
 
-				float targetSemi = (float)(targetOctave * 12) + scale.intervals[targetDegree];
-				float dev = (float)rootNote / 12.f + targetSemi / 12.f;
+				float targetSemi = tuning.semitones(targetIndex);
+				float dev = quant.rootVolts() + targetSemi / 12.f;
 				return clamp(dev, baseVoltage - faderRange, baseVoltage + faderRange);
 			}
 			else {
@@ -525,164 +887,659 @@ struct Fugue : Module {
 		}
 	}
 
+	// ─── Voice Routing ───────────────────────────────────────────────────────
+
+	int rowChannels(int row) {
+		return (numVoices - row + NUM_ROWS - 1) / NUM_ROWS;
+	}
+
+	// A polyphonic jack gives each voice in the row its own channel; a mono
+	// jack drives the whole row.
+	static float rowVoltage(Input& input, int channel) {
+		return input.getVoltage(channel < input.getChannels() ? channel : 0);
+	}
+
 	// ─── Clock Normalling ────────────────────────────────────────────────────
 
 	float getClockVoltage(int voiceIdx) {
-		switch (voiceIdx) {
-			case 0: return inputs[CLOCK_A_INPUT].getVoltage();
-			case 1:
-				if (inputs[CLOCK_B_INPUT].isConnected())
-					return inputs[CLOCK_B_INPUT].getVoltage();
-				return inputs[CLOCK_A_INPUT].getVoltage();
-			case 2:
-				if (inputs[CLOCK_C_INPUT].isConnected())
-					return inputs[CLOCK_C_INPUT].getVoltage();
-				if (inputs[CLOCK_B_INPUT].isConnected())
-					return inputs[CLOCK_B_INPUT].getVoltage();
-				return inputs[CLOCK_A_INPUT].getVoltage();
-			default: return 0.f;
-		}
+		// Clock C normals to B, B normals to A
+		int input = CLOCK_A_INPUT + voiceIdx % NUM_ROWS;
+		while (input > CLOCK_A_INPUT && !inputs[input].isConnected()) input--;
+		return rowVoltage(inputs[input], voiceIdx / NUM_ROWS);
 	}
 
 	// ─── Adaptive Slew ──────────────────────────────────────────────────────
 
 	void calculateSlewRate(int voiceIdx, int numSteps, float slewPercent) {
-		VoiceState& voice = voices[voiceIdx];
-
 		if (slewPercent < 0.001f) {
-			voice.slewRate = 0.f;
+			voices.slewRate[voiceIdx] = 0.f;
 			return;
 		}
 
-		// Find steps to next active gate for this voice
-		int stepsToNext = 0;
-		for (int i = 1; i <= numSteps; i++) {
-			int checkStep = (voice.currentStep + i) % numSteps;
-			int toggleIdx = checkStep * NUM_VOICES + voiceIdx;
-			if (params[GATE_TOGGLE_PARAM_0 + toggleIdx].getValue() > 0.5f) {
-				stepsToNext = i;
-				break;
+		// Steps to next active gate for this voice
+		numSteps = clamp(numSteps, 1, MAX_STEPS);
+		if (gateDistanceRevision[voiceIdx] != gatesRevision || gateDistanceSteps[voiceIdx] != numSteps) {
+			buildGateDistance(voiceIdx, numSteps);
+		}
+		int step = clamp(voices.currentStep[voiceIdx], 0, numSteps - 1);
+		setSlewRate(voiceIdx, gateDistance[voiceIdx][step], slewPercent);
+	}
+
+	// Walk the unrolled sequence backwards once; a step with no other gated
+	// step ahead of it gets a full cycle
+	void buildGateDistance(int voiceIdx, int numSteps) {
+		int row = voiceIdx % NUM_ROWS;
+		int nextGated = -1;
+		for (int k = 2 * numSteps - 1; k >= 0; k--) {
+			if (k < numSteps) {
+				gateDistance[voiceIdx][k] = (uint8_t)(nextGated >= 0 ? nextGated - k : numSteps);
 			}
+			if (sequence.gate(k % numSteps, row)) nextGated = k;
+		}
+		gateDistanceRevision[voiceIdx] = gatesRevision;
+		gateDistanceSteps[voiceIdx] = numSteps;
+	}
+
+	// Slew so the glide lands within slewPercent of the time to the next gate
+	void setSlewRate(int voiceIdx, int stepsToNext, float slewPercent) {
+		if (slewPercent < 0.001f) {
+			voices.slewRate[voiceIdx] = 0.f;
+			return;
 		}
-		if (stepsToNext == 0) stepsToNext = numSteps;
 
-		float timeAvailable = stepsToNext * voice.clockPeriod;
+		float timeAvailable = stepsToNext * voices.clockPeriod[voiceIdx];
 		float slewTime = std::max(slewPercent * timeAvailable, 0.001f);
-		float voltageDiff = std::abs(voice.targetVoltage - voice.currentVoltage);
+		float voltageDiff = std::abs(voices.targetVoltage[voiceIdx] - voices.currentVoltage[voiceIdx]);
 
 		if (voltageDiff < 0.0001f) {
-			voice.slewRate = 0.f;
+			voices.slewRate[voiceIdx] = 0.f;
 		} else {
-			voice.slewRate = voltageDiff / slewTime;
+			voices.slewRate[voiceIdx] = voltageDiff / slewTime;
 		}
 	}
 
 	void processSlew(int voiceIdx, float sampleTime) {
-		VoiceState& voice = voices[voiceIdx];
+		float& current = voices.currentVoltage[voiceIdx];
+		float target = voices.targetVoltage[voiceIdx];
+		float rate = voices.slewRate[voiceIdx];
 
-		if (voice.slewRate <= 0.f) {
-			voice.currentVoltage = voice.targetVoltage;
+		if (rate <= 0.f) {
+			current = target;
 		} else {
-			float diff = voice.targetVoltage - voice.currentVoltage;
-			float maxStep = voice.slewRate * sampleTime;
+			float diff = target - current;
+			float maxStep = rate * sampleTime;
 			if (std::abs(diff) <= maxStep) {
-				voice.currentVoltage = voice.targetVoltage;
+				current = target;
 			} else {
-				voice.currentVoltage += (diff > 0.f ? maxStep : -maxStep);
+				current += (diff > 0.f ? maxStep : -maxStep);
 			}
 		}
 	}
 
 	// ─── Consonance Scoring ─────────────────────────────────────────────────
 
-	float scoreConsonance(float candidateVolt, int voiceIdx) {
-		float score = 0.f;
-		int count = 0;
-		for (int v = 0; v < NUM_VOICES; v++) {
+	// Sum of the other voices' lock table rows: field[q] is the total
+	// consonance of pitch class q against everything else sounding. Built a
+	// row at a time, four classes per add.
+	static void buildConsonanceField(const float* targets, int count, int voiceIdx, float* field) {
+		const LockTable& table = lockTable();
+		float_4 acc[LOCK_CLASSES / 4];
+		for (int k = 0; k < LOCK_CLASSES / 4; k++) acc[k] = float_4::zero();
+
+		for (int v = 0; v < count; v++) {
 			if (v == voiceIdx) continue;
-			int interval = (int)std::round((candidateVolt - voices[v].targetVoltage) * 12.f);
-			score += intervalConsonance(interval);
-			count++;
+			const float* row = table.rows[lockClass(targets[v])];
+			for (int k = 0; k < LOCK_CLASSES / 4; k++) {
+				acc[k] += float_4::load(row + 4 * k);
+			}
 		}
-		return count > 0 ? score / (float)count : 1.f;
+		for (int k = 0; k < LOCK_CLASSES / 4; k++) acc[k].store(field + 4 * k);
+	}
+
+	// Best-scoring candidate against the other voices' targets
+	static float pickCandidate(const float* candidates, int numCandidates,
+	                           const float* targets, int count, int voiceIdx) {
+		if (numCandidates == 1) return candidates[0];
+
+		alignas(16) float field[LOCK_CLASSES];
+		buildConsonanceField(targets, count, voiceIdx, field);
+
+		float bestVolt = candidates[0];
+		float bestScore = -1.f;
+		for (int c = 0; c < numCandidates; c++) {
+			float score = field[lockClass(candidates[c])];
+			if (score > bestScore) {
+				bestScore = score;
+				bestVolt = candidates[c];
+			}
+		}
+		return bestVolt;
 	}
 
 	// ─── Step Advance ────────────────────────────────────────────────────────
 
-	void onVoiceStepAdvance(int voiceIdx) {
-		onVoiceStepAdvanceWithRange(voiceIdx, faderRangeVolts);
+	// Everything a voice's note choice depends on besides its step position
+	struct StepContext {
+		int rootNote;
+		std::shared_ptr<const Tuning> tuning;   // keeps a Scala tuning alive for the worker
+		const MarkovModel* model;   // nullptr = fixed tiers
+		uint32_t modelRevision;
+		float range;
+		float stability;
+		int numCandidates;
+		int numSteps;
+		float slewPercent;
+	};
+
+	// Read slew with CV (±5V = ±100%)
+	float readSlewPercent() {
+		float slewPercent = params[SLEW_PARAM].getValue();
+		if (inputs[SLEW_CV_INPUT].isConnected()) {
+			slewPercent += inputs[SLEW_CV_INPUT].getVoltage() / 5.f;
+		}
+		return clamp(slewPercent, 0.f, 1.f);
 	}
 
-	void onVoiceStepAdvanceWithRange(int voiceIdx, float rangeVolts) {
-		VoiceState& voice = voices[voiceIdx];
+	// One clock of the learn source: the interval from the last note it
+	// played becomes a transition once there's an interval before it
+	void learnInterval() {
+		int note = (int)std::round(inputs[ROOT_CV_INPUT].getVoltage() * 12.f);
+		if (learnHeld >= 1) {
+			int interval = note - learnLastNote;
+			if (learnHeld >= 2) markov.learn(learnLastInterval, interval);
+			learnLastInterval = interval;
+		}
+		learnLastNote = note;
+		learnHeld = std::min(learnHeld + 1, 2);
+	}
+
+	StepContext readStepContext(int voiceIdx, float rangeVolts) {
+		StepContext ctx;
+		int row = voiceIdx % NUM_ROWS;
 
 		// Read root with CV (1V = 1 semitone, wraps 0-11)
+		// (not while the jack is feeding the learned model)
 		int rootNote = (int)std::round(params[ROOT_PARAM].getValue());
-		if (inputs[ROOT_CV_INPUT].isConnected()) {
+		if (inputs[ROOT_CV_INPUT].isConnected() && !learnFromRootCv) {
 			rootNote += (int)std::round(inputs[ROOT_CV_INPUT].getVoltage());
 		}
-		rootNote = ((rootNote % 12) + 12) % 12;
+		ctx.rootNote = ((rootNote % 12) + 12) % 12;
 
-		// Read scale with CV (1V = 1 scale index, clamped 0-11)
+		// Read scale with CV (1V = 1 scale index, clamped to the scale list)
 		int scaleIndex = (int)std::round(params[SCALE_PARAM].getValue());
 		if (inputs[SCALE_CV_INPUT].isConnected()) {
 			scaleIndex += (int)std::round(inputs[SCALE_CV_INPUT].getVoltage());
 		}
-		scaleIndex = clamp(scaleIndex, 0, 11);
-
-		int numSteps = (int)std::round(params[STEPS_PARAM].getValue());
-
-		// Read slew with CV (±5V = ±100%)
-		float slewPercent = params[SLEW_PARAM].getValue();
-		if (inputs[SLEW_CV_INPUT].isConnected()) {
-			slewPercent += inputs[SLEW_CV_INPUT].getVoltage() / 5.f;
-		}
-		slewPercent = clamp(slewPercent, 0.f, 1.f);
+		ctx.tuning = activeTuning(scaleIndex);
+		ctx.range = rangeVolts;
 
-		// Get base voltage from current step's fader
-		float faderValue = params[FADER_PARAM_0 + voice.currentStep].getValue();
-		float baseVolt = faderToVoltage(faderValue, rootNote, scaleIndex, rangeVolts);
+		ctx.numSteps = (int)std::round(params[STEPS_PARAM].getValue());
+		ctx.slewPercent = readSlewPercent();
 
 		// Read wander with CV (0=faithful, 1=wanders; invert for internal stability)
-		float instability = params[WANDER_A_PARAM + voiceIdx].getValue();
-		if (inputs[WANDER_A_INPUT + voiceIdx].isConnected()) {
-			instability += inputs[WANDER_A_INPUT + voiceIdx].getVoltage() / 5.f;
+		float instability = params[WANDER_A_PARAM + row].getValue();
+		if (inputs[WANDER_A_INPUT + row].isConnected()) {
+			instability += rowVoltage(inputs[WANDER_A_INPUT + row], voiceIdx / NUM_ROWS) / 5.f;
 		}
 		instability = clamp(instability, 0.f, 1.f);
-		float stability = 1.f - instability;
+		ctx.stability = 1.f - instability;
+
+		// Harmonic Lock: each voice deviates from its own step's fader note but
+		// biases toward intervals consonant with the other voices. Lock
+		// strength sets how many seeded candidates compete (1 at 0%, 32 at
+		// 100%); the one scoring best against the other voices wins.
+		ctx.numCandidates = 1;
+		if (harmonicLock) {
+			float strength = clamp(params[LOCK_STRENGTH_PARAM].getValue(), 0.f, 1.f);
+			ctx.numCandidates = 1 + (int)std::round(strength * (LOCK_CANDIDATES - 1));
+		}
 
-		// Generate seed from step counter, voice, and step position
-		uint32_t seed = voice.stepCounter * 2654435761u
+		bool learned = learnedDeviation && markov.transitions() > 0;
+		ctx.model = learned ? &markov : nullptr;
+		ctx.modelRevision = learned ? markov.revision : 0;
+		return ctx;
+	}
+
+	// Seed from step counter, voice, and step position
+	static uint32_t stepSeed(uint32_t stepCounter, int voiceIdx, int step) {
+		uint32_t seed = stepCounter * 2654435761u
 		              + voiceIdx * 340573321u
-		              + voice.currentStep * 1234577u;
+		              + step * 1234577u;
 		// Ensure seed is non-zero for xorshift
-		if (seed == 0) seed = 1;
+		return seed == 0 ? 1 : seed;
+	}
 
-		// Harmonic Lock: each voice deviates from its own step's fader note but
-		// biases toward intervals consonant with the other voices. Generate 3
-		// candidates and pick the one that scores best against the other voices.
-		if (harmonicLock) {
-			float bestVolt = baseVolt;
-			float bestScore = -1.f;
-			for (int c = 0; c < 3; c++) {
-				uint32_t candidateSeed = seed + c * 7919u;
-				if (candidateSeed == 0) candidateSeed = 1;
-				float candidate = selectDeviationNote(
-					baseVolt, stability, rootNote, scaleIndex, rangeVolts, candidateSeed);
-				float score = scoreConsonance(candidate, voiceIdx);
-				if (score > bestScore) {
-					bestScore = score;
-					bestVolt = candidate;
+	static void generateCandidates(float baseVolt, float stability, const ScaleQuantizer& quant,
+	                               uint32_t seed, int numCandidates, float* out,
+	                               const MarkovModel* model, int context) {
+		for (int c = 0; c < numCandidates; c++) {
+			uint32_t candidateSeed = seed + c * 7919u;
+			if (candidateSeed == 0) candidateSeed = 1;
+			out[c] = selectDeviationNote(baseVolt, stability, quant, candidateSeed, model, context);
+		}
+	}
+
+	// Written interval into `step` from the step before it, in semitones:
+	// what the learned model conditions on
+	static int writtenInterval(const ScaleQuantizer& quant, const float* pitches,
+	                           int step, int numSteps, float baseVolt) {
+		int prev = (step + numSteps - 1) % numSteps;
+		return (int)std::round((baseVolt - quant.quantize(pitches[prev])) * 12.f);
+	}
+
+	void onVoiceStepAdvance(int voiceIdx) {
+		onVoiceStepAdvanceWithRange(voiceIdx, faderRangeVolts);
+	}
+
+	void onVoiceStepAdvanceWithRange(int voiceIdx, float rangeVolts) {
+		StepContext ctx = readStepContext(voiceIdx, rangeVolts);
+		int step = voices.currentStep[voiceIdx];
+
+		// Get base voltage from current step's fader
+		float faderValue = sequence.pitch[clamp(step, 0, MAX_STEPS - 1)];
+		ScaleQuantizer& quant = quantizers[voiceIdx];
+		quant.update(ctx.tuning, ctx.rootNote, ctx.range);
+		float baseVolt = quant.quantize(faderValue);
+
+		// At full stability every candidate is the base note
+		if (ctx.stability >= 0.999f) {
+			voices.targetVoltage[voiceIdx] = baseVolt;
+		} else {
+			int context = ctx.model ? writtenInterval(quant, sequence.pitch, step,
+				std::max(voiceStepCounts[voiceIdx], 1), baseVolt) : 0;
+			const float* candidates = lookaheadCandidates(voiceIdx, ctx, faderValue, context);
+			float live[LOCK_CANDIDATES];
+			if (!candidates) {
+				uint32_t seed = stepSeed(voices.stepCounter[voiceIdx], voiceIdx, step);
+				generateCandidates(baseVolt, ctx.stability, quant, seed, ctx.numCandidates, live,
+					ctx.model, context);
+				candidates = live;
+				lookaheadWanted = true;
+			}
+			voices.targetVoltage[voiceIdx] = pickCandidate(
+				candidates, ctx.numCandidates, voices.targetVoltage, numVoices, voiceIdx);
+		}
+
+		// Calculate adaptive slew
+		calculateSlewRate(voiceIdx, ctx.numSteps, ctx.slewPercent);
+	}
+
+	// ─── Look-Ahead ──────────────────────────────────────────────────────────
+	// A background thread renders every voice's deviation candidates for its
+	// next 64 steps, so a clock edge only scores them against the other voices
+	// (or, with Harmonic Lock off, takes the single candidate). Each entry
+	// keeps the controls it was rendered from; if any of them moved, the edge
+	// falls back to live selection and asks for a fresh render.
+
+	struct LookaheadEntry {
+		uint32_t stepCounter;
+		int step;
+		int rootNote;
+		uint32_t tuningSerial;
+		float range;
+		float stability;
+		float faderValue;
+		uint32_t modelRevision;
+		int context;
+		int numCandidates;      // 0 = never rendered
+		float candidates[LOCK_CANDIDATES];
+	};
+
+	struct LookaheadBuffer {
+		LookaheadEntry entries[MAX_VOICES][LOOKAHEAD_STEPS];
+	};
+
+	struct LookaheadRequest {
+		int numVoices;
+		float faders[MAX_STEPS];
+		uint8_t gates[MAX_STEPS];
+		float targets[MAX_VOICES];
+		MarkovModel model;      // snapshot; the live one keeps learning
+		struct Voice {
+			uint32_t stepCounter;
+			int step;
+			bool firstClockPending;
+			int numSteps;
+			StepContext ctx;
+		} voices[MAX_VOICES];
+	};
+
+	std::vector<LookaheadBuffer> lookaheadBuffers = std::vector<LookaheadBuffer>(2);
+	std::atomic<int> lookaheadFront{-1};   // buffer the audio thread reads, -1 = none yet
+	std::atomic<bool> lookaheadBusy{false};
+	LookaheadRequest lookaheadRequest;
+	uint32_t lookaheadStart[MAX_VOICES] = {};
+	std::atomic<bool> lookaheadWanted{true};   // also set from the GUI
+	ScaleQuantizer lookaheadQuantizers[MAX_VOICES];   // worker thread only
+
+	std::thread lookaheadThread;
+	std::mutex lookaheadMutex;
+	std::condition_variable lookaheadCv;
+	uint64_t lookaheadGeneration = 0;
+	bool lookaheadQuit = false;
+
+	// Upcoming notes of each row's first voice for the context menu (NAN = rest).
+	// The worker fills the back copy and then publishes its index, so the GUI
+	// never reads a half-written preview.
+	float previewNotes[2][NUM_ROWS][PREVIEW_STEPS];
+	std::atomic<int> previewFront{0};
+
+	const float* lookaheadCandidates(int v, const StepContext& ctx, float faderValue, int context) {
+		int front = lookaheadFront.load();
+		if (front < 0) return nullptr;
+		uint32_t counter = voices.stepCounter[v];
+		const LookaheadEntry& e = lookaheadBuffers[front].entries[v][counter % LOOKAHEAD_STEPS];
+		if (e.numCandidates < ctx.numCandidates || e.stepCounter != counter
+			|| e.step != voices.currentStep[v] || e.faderValue != faderValue
+			|| e.rootNote != ctx.rootNote || e.tuningSerial != ctx.tuning->serial
+			|| e.range != ctx.range || e.stability != ctx.stability
+			|| e.modelRevision != ctx.modelRevision || e.context != context)
+			return nullptr;
+		// Ask for more before the ring runs out
+		if (counter - lookaheadStart[v] >= LOOKAHEAD_STEPS / 2) lookaheadWanted = true;
+		return e.candidates;
+	}
+
+	// Snapshot the controls for the worker. Called at the end of process(),
+	// after this sample's reads of the front buffer, so the buffer the worker
+	// fills next is never one the audio thread is still looking at. The audio
+	// thread never waits: if the worker holds the lock, lookaheadWanted stays
+	// set and the next sample tries again.
+	void requestLookahead() {
+		if (lookaheadBusy.load()) return;
+		{
+			std::unique_lock<std::mutex> lock(lookaheadMutex, std::try_to_lock);
+			if (!lock.owns_lock()) return;
+			LookaheadRequest& req = lookaheadRequest;
+			req.numVoices = numVoices;
+			std::memcpy(req.faders, sequence.pitch, sizeof(req.faders));
+			std::memcpy(req.gates, sequence.gates, sizeof(req.gates));
+			if (learnedDeviation) req.model = markov;
+			for (int v = 0; v < numVoices; v++) {
+				req.targets[v] = voices.targetVoltage[v];
+				req.voices[v].stepCounter = voices.stepCounter[v];
+				req.voices[v].step = voices.currentStep[v];
+				req.voices[v].firstClockPending = voices.firstClockPending[v];
+				req.voices[v].numSteps = voiceStepCounts[v];
+				req.voices[v].ctx = readStepContext(v, voiceRanges[v]);
+				lookaheadStart[v] = voices.stepCounter[v];
+			}
+			lookaheadBusy.store(true);
+			lookaheadGeneration++;
+		}
+		lookaheadWanted = false;
+		lookaheadCv.notify_one();
+	}
+
+	void lookaheadLoop() {
+		uint64_t seen = 0;
+		while (true) {
+			LookaheadRequest req;
+			{
+				std::unique_lock<std::mutex> lock(lookaheadMutex);
+				lookaheadCv.wait(lock, [&]() { return lookaheadQuit || lookaheadGeneration != seen; });
+				if (lookaheadQuit) return;
+				seen = lookaheadGeneration;
+				req = lookaheadRequest;
+			}
+			int back = (lookaheadFront.load() == 0) ? 1 : 0;
+			renderLookahead(req, lookaheadBuffers[back]);
+			lookaheadFront.store(back);
+			lookaheadBusy.store(false);
+		}
+	}
+
+	void renderLookahead(const LookaheadRequest& req, LookaheadBuffer& out) {
+		int previewBack = 1 - previewFront.load();
+		float (*preview)[PREVIEW_STEPS] = previewNotes[previewBack];
+		for (int r = 0; r < NUM_ROWS; r++) {
+			for (int i = 0; i < PREVIEW_STEPS; i++) preview[r][i] = NAN;
+		}
+		for (int v = 0; v < req.numVoices; v++) {
+			const LookaheadRequest::Voice& rv = req.voices[v];
+			const StepContext& ctx = rv.ctx;
+			const MarkovModel* model = ctx.model ? &req.model : nullptr;
+			ScaleQuantizer& quant = lookaheadQuantizers[v];
+			quant.update(ctx.tuning, ctx.rootNote, ctx.range);
+
+			// Entry 0 is the current position (what the first clock after a
+			// reset plays); each later one follows the clock path's step logic
+			uint32_t counter = rv.stepCounter;
+			int step = rv.step;
+			int previewCount = 0;
+			for (int k = 0; k < LOOKAHEAD_STEPS; k++) {
+				if (k > 0) {
+					counter++;
+					step++;
+					if (step >= rv.numSteps) step = 0;
+				}
+				step = clamp(step, 0, MAX_STEPS - 1);
+				LookaheadEntry& e = out.entries[v][counter % LOOKAHEAD_STEPS];
+				e.stepCounter = counter;
+				e.step = step;
+				e.rootNote = ctx.rootNote;
+				e.tuningSerial = ctx.tuning->serial;
+				e.range = ctx.range;
+				e.stability = ctx.stability;
+				e.faderValue = req.faders[step];
+				e.modelRevision = ctx.modelRevision;
+				e.numCandidates = ctx.numCandidates;
+				float baseVolt = quant.quantize(e.faderValue);
+				e.context = model ? writtenInterval(quant, req.faders, step,
+					std::max(rv.numSteps, 1), baseVolt) : 0;
+				generateCandidates(baseVolt, ctx.stability, quant,
+					stepSeed(counter, v, step), ctx.numCandidates, e.candidates, model, e.context);
+
+				// Preview: the note each upcoming clock would play, scored
+				// against the other voices as they stand now
+				bool upcoming = (k > 0) || rv.firstClockPending;
+				if (v < NUM_ROWS && upcoming && previewCount < PREVIEW_STEPS) {
+					float note = (ctx.stability >= 0.999f) ? baseVolt : pickCandidate(
+						e.candidates, ctx.numCandidates, req.targets, req.numVoices, v);
+					preview[v][previewCount++] = ((req.gates[step] >> v) & 1) ? note : NAN;
 				}
 			}
-			voice.targetVoltage = bestVolt;
+		}
+		previewFront.store(previewBack);
+	}
+
+	void startLookahead() {
+		for (int b = 0; b < 2; b++) {
+			for (int r = 0; r < NUM_ROWS; r++) {
+				for (int i = 0; i < PREVIEW_STEPS; i++) previewNotes[b][r][i] = NAN;
+			}
+		}
+		lookaheadThread = std::thread([this]() { lookaheadLoop(); });
+	}
+
+	void stopLookahead() {
+		{
+			std::lock_guard<std::mutex> lock(lookaheadMutex);
+			lookaheadQuit = true;
+		}
+		lookaheadCv.notify_all();
+		if (lookaheadThread.joinable()) lookaheadThread.join();
+	}
+
+	// ─── Note History ────────────────────────────────────────────────────────
+	// Each voice's note and gate at every clock edge, in a ring the GUI reads
+	// without locking: the audio thread fills the slot, then publishes the new
+	// count. Freezing copies the last N edges into a phrase that replays edge
+	// for edge with no deviation at all, and is saved with the patch.
+
+	struct HistoryEvent {
+		float note;
+		bool gate;
+	};
+
+	struct Phrase {
+		int length = 0;        // edges per voice, 0 = not frozen
+		int numVoices = 0;
+		float notes[MAX_VOICES][HISTORY_LENGTH];
+		bool gates[MAX_VOICES][HISTORY_LENGTH];
+	};
+
+	HistoryEvent history[MAX_VOICES][HISTORY_LENGTH];
+	std::atomic<uint32_t> historyCount[MAX_VOICES];
+	Phrase phrase;                              // audio thread
+	Phrase pendingPhrase;                       // GUI → audio thread
+	std::atomic<bool> phrasePending{false};
+	int phrasePos[MAX_VOICES];                  // last replayed edge, -1 = none yet
+	bool phraseGate[MAX_VOICES] = {};
+
+	void recordHistory(int v, float note, bool gate) {
+		uint32_t n = historyCount[v].load(std::memory_order_relaxed);
+		history[v][n % HISTORY_LENGTH].note = note;
+		history[v][n % HISTORY_LENGTH].gate = gate;
+		historyCount[v].store(n + 1, std::memory_order_release);
+	}
+
+	// GUI thread. Voices with fewer edges than asked for are padded with rests
+	// at the front. The audio thread would have to clock a voice 64 times
+	// during the copy to overwrite what's being read.
+	void freezeHistory(int length) {
+		if (phrasePending.load()) return;
+		Phrase& p = pendingPhrase;
+		p.length = clamp(length, 1, HISTORY_LENGTH);
+		p.numVoices = numVoices;
+		for (int v = 0; v < p.numVoices; v++) {
+			uint32_t end = historyCount[v].load(std::memory_order_acquire);
+			int available = (int)std::min(end, (uint32_t)p.length);
+			int pad = p.length - available;
+			for (int i = 0; i < p.length; i++) {
+				if (i < pad) {
+					p.notes[v][i] = available > 0 ? history[v][(end - available) % HISTORY_LENGTH].note : 0.f;
+					p.gates[v][i] = false;
+				} else {
+					const HistoryEvent& e = history[v][(end - p.length + i) % HISTORY_LENGTH];
+					p.notes[v][i] = e.note;
+					p.gates[v][i] = e.gate;
+				}
+			}
+		}
+		phrasePending.store(true);
+	}
+
+	void releasePhrase() {
+		if (phrasePending.load()) return;
+		pendingPhrase.length = 0;
+		pendingPhrase.numVoices = 0;
+		phrasePending.store(true);
+	}
+
+	bool replaying(int v) {
+		return phrase.length > 0 && v < phrase.numVoices;
+	}
+
+	void replayStep(int v, int numSteps) {
+		int pos = (phrasePos[v] + 1) % phrase.length;
+		phrasePos[v] = pos;
+		voices.targetVoltage[v] = phrase.notes[v][pos];
+		phraseGate[v] = phrase.gates[v][pos];
+
+		// The live step keeps counting under the phrase, so the step display
+		// stays inside the voice's length and unfreezing resumes in time
+		if (voices.firstClockPending[v]) {
+			voices.firstClockPending[v] = false;
 		} else {
-			voice.targetVoltage = selectDeviationNote(
-				baseVolt, stability, rootNote, scaleIndex, rangeVolts, seed);
+			voices.stepCounter[v]++;
+			voices.currentStep[v] = (voices.currentStep[v] + 1) % std::max(numSteps, 1);
 		}
 
-		// Calculate adaptive slew
-		calculateSlewRate(voiceIdx, numSteps, slewPercent);
+		// Slew toward the next gated edge, as the live path does
+		int stepsToNext = phrase.length;
+		for (int i = 1; i <= phrase.length; i++) {
+			if (phrase.gates[v][(pos + i) % phrase.length]) {
+				stepsToNext = i;
+				break;
+			}
+		}
+		setSlewRate(v, stepsToNext, readSlewPercent());
+	}
+
+	void resetVoice(int v) {
+		voices.currentStep[v] = 0;
+		voices.stepCounter[v] = 0;
+		sleeping[v] = false;
+		sleepCounter[v] = 0;
+		sampleHoldHolding[v] = false;
+		// First clock after Reset should fire step 1 (currentStep=0)
+		// instead of skipping it by incrementing to step 2. The flag
+		// makes the first post-reset clock "land on" step 0 rather
+		// than advance past it.
+		voices.firstClockPending[v] = true;
+		phrasePos[v] = -1;
+	}
+
+	// Voices added from the menu pick up their row's position so a shared
+	// clock keeps them in step with the voices already running.
+	void joinVoice(int v) {
+		int lead = v % NUM_ROWS;
+		voices.currentStep[v] = voices.currentStep[lead];
+		voices.stepCounter[v] = voices.stepCounter[lead];
+		voices.clockPeriod[v] = voices.clockPeriod[lead];
+		voices.firstClockPending[v] = voices.firstClockPending[lead];
+		sleeping[v] = sleeping[lead];
+		sleepCounter[v] = sleepCounter[lead];
+		sampleHoldHolding[v] = false;
+		probGateSuppress[v] = false;
+		onVoiceStepAdvance(v);
+		voices.currentVoltage[v] = voices.targetVoltage[v];
+	}
+
+	// ─── Sequence Paging ─────────────────────────────────────────────────────
+
+	void showPage(int page) {
+		int base = page * NUM_STEPS;
+		for (int i = 0; i < NUM_STEPS; i++) {
+			params[FADER_PARAM_0 + i].setValue(sequence.pitch[base + i]);
+			for (int r = 0; r < NUM_ROWS; r++) {
+				params[GATE_TOGGLE_PARAM_0 + i * NUM_ROWS + r].setValue(
+					sequence.gate(base + i, r) ? 1.f : 0.f);
+			}
+			shownPitch[i] = sequence.pitch[base + i];
+			shownGates[i] = sequence.gates[base + i];
+		}
+		shownPage = page;
+	}
+
+	// Copy panel edits into the sequence, or the sequence out to the panel
+	// when the page changes. Touches only the 8 faders and 24 toggles, so
+	// the cost doesn't grow with the sequence. After a patch load the panel
+	// is taken as the truth for the page it shows.
+	void syncPanel() {
+		int page = clamp((int)std::round(params[PAGE_PARAM].getValue()), 0, NUM_PAGES - 1);
+		if (shownPage >= 0 && page != shownPage) {
+			showPage(page);
+			return;
+		}
+		bool adopt = (shownPage < 0);
+		shownPage = page;
+
+		int base = page * NUM_STEPS;
+		for (int i = 0; i < NUM_STEPS; i++) {
+			float pitch = params[FADER_PARAM_0 + i].getValue();
+			if (adopt || pitch != shownPitch[i]) {
+				sequence.pitch[base + i] = pitch;
+				shownPitch[i] = pitch;
+			}
+			uint8_t gates = 0;
+			for (int r = 0; r < NUM_ROWS; r++) {
+				if (params[GATE_TOGGLE_PARAM_0 + i * NUM_ROWS + r].getValue() > 0.5f) gates |= 1 << r;
+			}
+			if (adopt || gates != shownGates[i]) {
+				sequence.gates[base + i] = gates;
+				shownGates[i] = gates;
+				gatesRevision++;
+			}
+		}
+	}
+
+	void randomizeSequence() {
+		for (int i = 0; i < MAX_STEPS; i++) {
+			sequence.pitch[i] = random::uniform();
+		}
+		showPage(std::max(shownPage, 0));
 	}
 
 	// ─── Process ─────────────────────────────────────────────────────────────
@@ -691,104 +1548,136 @@ struct Fugue : Module {
 		int numSteps = (int)std::round(params[STEPS_PARAM].getValue());
 		if (inputs[STEPS_CV_INPUT].isConnected()) {
 			numSteps += (int)std::round(inputs[STEPS_CV_INPUT].getVoltage());
-			numSteps = clamp(numSteps, 1, 8);
+		}
+		numSteps = clamp(numSteps, 1, MAX_STEPS);
+
+		// ── Panel ↔ sequence ──
+		syncPanel();
+
+		// ── Pick up a freeze or release from the GUI ──
+		if (phrasePending.load()) {
+			phrase = pendingPhrase;
+			for (int v = 0; v < MAX_VOICES; v++) phrasePos[v] = -1;
+			phrasePending.store(false);
+		}
+
+		// ── Voice count change ──
+		if (numVoices != activeVoices) {
+			for (int v = activeVoices; v < numVoices; v++) {
+				joinVoice(v);
+			}
+			activeVoices = numVoices;
 		}
 
 		// ── Read expander overrides ──
-		ExpanderToFugueMessage expanderMsg = {};
-		expanderMsg.sampleHoldEnabled = false;
-		for (int v = 0; v < NUM_VOICES; v++) {
-			expanderMsg.voices[v].stepsOverride = -1;
-			expanderMsg.voices[v].rangeOverride = -1.f;
-			expanderMsg.voices[v].sleepDivision = 0;   // 0 = no sleep
-			expanderMsg.voices[v].probability = 1.f;
-		}
-
-		if (rightExpander.module && rightExpander.module->model == modelFugueX) {
-			ExpanderToFugueMessage* rxMsg =
-				(ExpanderToFugueMessage*)rightExpander.module->leftExpander.consumerMessage;
-			if (rxMsg && rxMsg->connected) {
-				expanderMsg = *rxMsg;
+		// The nearest expander's overrides apply; a randomize from any
+		// expander along the chain arrives through the link.
+		const ExpanderToFugueMessage* overrides = &defaultOverrides;
+		bool randomizeRequested = randomizeWanted.exchange(false);
+		if (link.randomizeRequests.exchange(0) > 0) randomizeRequested = true;
+		bool hasExpander = isFugueExpander(rightExpander.module);
+		if (hasExpander) {
+			const FugueBusMessage* rxBus =
+				(const FugueBusMessage*)rightExpander.module->leftExpander.consumerMessage;
+			const FugueSectionHeader* section = rxBus ? rxBus->find(FUGUE_SECTION_OVERRIDES) : nullptr;
+			if (overrideReader.read(section) && overrideReader.value.connected) {
+				overrides = &overrideReader.value;
 			}
 		}
+		const ExpanderToFugueMessage& expanderMsg = *overrides;
 
 		sampleHoldEnabled = expanderMsg.sampleHoldEnabled;
 
 		// ── Handle randomize request ──
-		if (expanderMsg.randomizeRequested) {
-			for (int i = 0; i < NUM_STEPS; i++) {
-				params[FADER_PARAM_0 + i].setValue(random::uniform());
-			}
+		if (randomizeRequested) {
+			randomizeSequence();
+		}
+
+		if (markovClearWanted.exchange(false)) {
+			markov.clear();
+			learnHeld = 0;
 		}
 
 		// ── Reset (input or button) ──
 		bool resetTriggered = resetTrigger.process(inputs[RESET_INPUT].getVoltage(), 0.1f, 1.f);
 		bool resetBtnTriggered = resetButtonTrigger.process(params[RESET_BUTTON_PARAM].getValue());
 		if (resetTriggered || resetBtnTriggered) {
-			for (int v = 0; v < NUM_VOICES; v++) {
-				voices[v].currentStep = 0;
-				voices[v].stepCounter = 0;
-				sleeping[v] = false;
-				sleepCounter[v] = 0;
-				sampleHoldHolding[v] = false;
-				// First clock after Reset should fire step 1 (currentStep=0)
-				// instead of skipping it by incrementing to step 2. The flag
-				// makes the first post-reset clock "land on" step 0 rather
-				// than advance past it.
-				voices[v].firstClockPending = true;
+			for (int v = 0; v < MAX_VOICES; v++) {
+				resetVoice(v);
+			}
+			for (int v = 0; v < numVoices; v++) {
 				onVoiceStepAdvance(v);
 			}
 		}
 
-		// ── Prepare expander output message ──
-		FugueToExpanderMessage* txMsg = (FugueToExpanderMessage*)rightExpander.producerMessage;
+		// ── Prepare expander state (zeroed so the section writer's compare is exact) ──
+		FugueToExpanderMessage state;
+		std::memset(&state, 0, sizeof(state));
+
+		for (int r = 0; r < NUM_ROWS; r++) {
+			outputs[CV_A_OUTPUT + r].setChannels(rowChannels(r));
+			outputs[GATE_A_OUTPUT + r].setChannels(rowChannels(r));
+		}
 
 		// ── Per-voice clock processing ──
-		for (int v = 0; v < NUM_VOICES; v++) {
-			VoiceState& voice = voices[v];
+		for (int v = 0; v < numVoices; v++) {
+			int row = v % NUM_ROWS;
+			int channel = v / NUM_ROWS;
+			const ExpanderToFugueMessage::VoiceOverride& over = expanderMsg.voices[row];
 			float clockVolt = getClockVoltage(v);
 
 			// Per-voice step count (capped at global)
 			int voiceSteps = numSteps;
-			if (expanderMsg.voices[v].stepsOverride > 0) {
-				voiceSteps = std::min(expanderMsg.voices[v].stepsOverride, numSteps);
+			if (over.stepsOverride > 0) {
+				voiceSteps = std::min(over.stepsOverride, numSteps);
 			}
 
 			// Per-voice fader range override
 			float voiceRange = faderRangeVolts;
-			if (expanderMsg.voices[v].rangeOverride > 0.f) {
-				voiceRange = expanderMsg.voices[v].rangeOverride;
+			if (over.rangeOverride > 0.f) {
+				voiceRange = over.rangeOverride;
 			}
 
-			voice.clockHigh = (clockVolt >= 1.0f);
-			voice.clockTimer += args.sampleTime;
+			voiceStepCounts[v] = voiceSteps;
+			voiceRanges[v] = voiceRange;
+
+			voices.clockHigh[v] = (clockVolt >= 1.0f);
+			voices.clockTimer[v] += args.sampleTime;
 
 			bool clockRose = false;
-			if (voice.clockTrigger.process(clockVolt, 0.1f, 1.f)) {
+			if (voices.clockTrigger[v].process(clockVolt, 0.1f, 1.f)) {
 				clockRose = true;
-				if (voice.clockTimer > 0.001f) {
-					voice.clockPeriod = voice.clockTimer;
+				if (voices.clockTimer[v] > 0.001f) {
+					voices.clockPeriod[v] = voices.clockTimer[v];
+				}
+				voices.clockTimer[v] = 0.f;
+
+				if (v == 0 && learnFromRootCv && inputs[ROOT_CV_INPUT].isConnected()) {
+					learnInterval();
 				}
-				voice.clockTimer = 0.f;
 
 				// ── Sleep logic ──
-				int sleepDiv = expanderMsg.voices[v].sleepDivision;
-				if (sleeping[v]) {
+				int sleepDiv = over.sleepDivision;
+				if (replaying(v)) {
+					// Frozen phrase: the recorded edge already includes
+					// sleep, probability and gate toggles
+					replayStep(v, voiceSteps);
+				} else if (sleeping[v]) {
 					sleepCounter[v]--;
 					if (sleepCounter[v] <= 0) {
 						sleeping[v] = false;
 					}
 					// Don't advance step while sleeping
 				} else {
-					if (voice.firstClockPending) {
+					if (voices.firstClockPending[v]) {
 						// First clock after Reset: don't increment — sit on
 						// step 0 (visually step 1) so its gate fires now.
-						voice.firstClockPending = false;
+						voices.firstClockPending[v] = false;
 					} else {
-						voice.stepCounter++;
-						voice.currentStep++;
-						if (voice.currentStep >= voiceSteps) {
-							voice.currentStep = 0;
+						voices.stepCounter[v]++;
+						voices.currentStep[v]++;
+						if (voices.currentStep[v] >= voiceSteps) {
+							voices.currentStep[v] = 0;
 							// Start sleeping at end of cycle. sleepDiv == 0
 							// means "no sleep" (matches the FugueX dropdown's
 							// "0" entry).
@@ -800,7 +1689,7 @@ struct Fugue : Module {
 					}
 
 					// ── Probability ──
-					float prob = expanderMsg.voices[v].probability;
+					float prob = over.probability;
 					if (prob < 1.f) {
 						float roll = (float)(xorshift32(probRng) & 0x7FFFFFFF) / (float)0x7FFFFFFF;
 						probGateSuppress[v] = (roll >= prob);
@@ -812,13 +1701,20 @@ struct Fugue : Module {
 				}
 			}
 
+			bool stepGate;
+			if (replaying(v)) {
+				stepGate = phraseGate[v];
+			} else {
+				bool toggleOn = sequence.gate(clamp(voices.currentStep[v], 0, MAX_STEPS - 1), row);
+				stepGate = toggleOn && !sleeping[v] && !probGateSuppress[v];
+			}
+			if (clockRose) recordHistory(v, voices.targetVoltage[v], stepGate);
+
 			// ── Slew / S&H ──
 			if (sampleHoldEnabled) {
 				// In S&H mode, only update voltage when gate fires
-				int toggleIdx = voice.currentStep * NUM_VOICES + v;
-				bool toggleOn = params[GATE_TOGGLE_PARAM_0 + toggleIdx].getValue() > 0.5f;
-				if (clockRose && toggleOn && !sleeping[v] && !probGateSuppress[v]) {
-					voice.currentVoltage = voice.targetVoltage;
+				if (clockRose && stepGate) {
+					voices.currentVoltage[v] = voices.targetVoltage[v];
 					sampleHoldHolding[v] = true;
 				}
 			} else {
@@ -826,50 +1722,62 @@ struct Fugue : Module {
 			}
 
 			// ── CV output ──
-			outputs[CV_A_OUTPUT + v].setVoltage(voice.currentVoltage);
+			outputs[CV_A_OUTPUT + row].setVoltage(voices.currentVoltage[v], channel);
 
 			// ── Gate output ──
-			int toggleIdx = voice.currentStep * NUM_VOICES + v;
-			bool toggleOn = params[GATE_TOGGLE_PARAM_0 + toggleIdx].getValue() > 0.5f;
-			bool gateActive = voice.clockHigh && toggleOn && !sleeping[v] && !probGateSuppress[v];
-			outputs[GATE_A_OUTPUT + v].setVoltage(gateActive ? 10.f : 0.f);
-
-			// ── Fill expander message ──
-			if (txMsg) {
-				txMsg->voices[v].currentStep = voice.currentStep;
-				txMsg->voices[v].clockHigh = voice.clockHigh;
-				txMsg->voices[v].clockRose = clockRose;
-				txMsg->voices[v].currentVoltage = voice.currentVoltage;
-				txMsg->voices[v].gateOn = gateActive;
-				txMsg->voices[v].sleeping = sleeping[v];
-				txMsg->voices[v].sleepCounter = sleepCounter[v];
-				txMsg->voices[v].sleepDivision = expanderMsg.voices[v].sleepDivision;
+			bool gateActive = voices.clockHigh[v] && stepGate;
+			outputs[GATE_A_OUTPUT + row].setVoltage(gateActive ? 10.f : 0.f, channel);
+
+			// ── Fill expander state (FugueX shows each row's first voice) ──
+			if (channel == 0) {
+				FugueToExpanderMessage::VoiceInfo& info = state.voices[row];
+				info.currentStep = voices.currentStep[v];
+				info.clockHigh = voices.clockHigh[v];
+				info.clockRose = clockRose;
+				info.currentVoltage = voices.currentVoltage[v];
+				info.gateOn = gateActive;
+				info.sleeping = sleeping[v];
+				info.sleepCounter = sleepCounter[v];
+				info.sleepDivision = over.sleepDivision;
+				if (clockRose && hasExpander) {
+					FugueEdgeEvent edge;
+					edge.frame = args.frame;
+					edge.voice = row;
+					edge.step = voices.currentStep[v];
+					edge.gateOn = gateActive;
+					link.publishEdge(edge);
+				}
 			}
 		}
 
-		// ── Send expander message ──
-		if (txMsg) {
-			txMsg->numSteps = numSteps;
-			rightExpander.requestMessageFlip();
+		// ── Refresh the look-ahead once this sample is done with it ──
+		if (lookaheadWanted) requestLookahead();
+
+		// ── Publish expander state ──
+		if (hasExpander) {
+			state.numSteps = numSteps;
+			link.publishState(state);
 		}
 
-		// ── Update lights ──
-		for (int step = 0; step < NUM_STEPS; step++) {
-			for (int v = 0; v < NUM_VOICES; v++) {
-				int idx = step * NUM_VOICES + v;
-				float brightness = params[GATE_TOGGLE_PARAM_0 + idx].getValue();
-				if (step >= numSteps) brightness *= 0.15f;
-				lights[GATE_LIGHT_0 + idx].setBrightness(brightness);
-			}
+		// ── Follow the playhead: page to voice A's step ──
+		if (followPlayhead) {
+			int playPage = clamp(voices.currentStep[0] / NUM_STEPS, 0, NUM_PAGES - 1);
+			if (playPage != shownPage) params[PAGE_PARAM].setValue((float)playPage);
 		}
 
-		for (int step = 0; step < NUM_STEPS; step++) {
-			for (int v = 0; v < NUM_VOICES; v++) {
-				int toggleIdx = step * NUM_VOICES + v;
-				bool gateOn = params[GATE_TOGGLE_PARAM_0 + toggleIdx].getValue() > 0.5f;
+		// ── Update lights (the page shown) ──
+		int pageBase = std::max(shownPage, 0) * NUM_STEPS;
+		for (int i = 0; i < NUM_STEPS; i++) {
+			int step = pageBase + i;
+			for (int v = 0; v < NUM_ROWS; v++) {
+				bool gateOn = sequence.gate(step, v);
+				float brightness = gateOn ? 1.f : 0.f;
+				if (step >= numSteps) brightness *= 0.15f;
+				lights[GATE_LIGHT_0 + i * NUM_ROWS + v].setBrightness(brightness);
+
 				int lightBase = (v == 0) ? STEP_A_LIGHT_0 : (v == 1) ? STEP_B_LIGHT_0 : STEP_C_LIGHT_0;
-				lights[lightBase + step].setBrightness(
-					(step == voices[v].currentStep && step < numSteps && gateOn) ? 1.f : 0.f);
+				lights[lightBase + i].setBrightness(
+					(step == voices.currentStep[v] && step < numSteps && gateOn) ? 1.f : 0.f);
 			}
 		}
 	}
@@ -884,15 +1792,13 @@ std::string FaderParamQuantity::getDisplayValueString() {
 	int rootNote = (int)std::round(m->params[Fugue::ROOT_PARAM].getValue());
 	int scaleIndex = (int)std::round(m->params[Fugue::SCALE_PARAM].getValue());
 	float faderValue = getValue();
-	float voltage = m->faderToVoltage(faderValue, rootNote, scaleIndex, m->faderRangeVolts);
-
-	// Convert voltage to note name (0V = C4 in 1V/oct standard)
-	static const char* noteNames[] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
-	int totalSemitones = (int)std::round(voltage * 12.f);
-	int octave = 4 + (int)std::floor((float)totalSemitones / 12.f);
-	int noteIdx = ((totalSemitones % 12) + 12) % 12;
+	// Built locally: the module's quantizers belong to the audio thread
+	ScaleQuantizer quant;
+	quant.update(Fugue::pickTuning(m->scalaTuning.get(), m->useScalaTuning, scaleIndex),
+		rootNote, m->faderRangeVolts);
+	float voltage = quant.quantize(faderValue);
 
-	return string::f("%s%d", noteNames[noteIdx], octave);
+	return voltageToNoteName(voltage);
 }
 
 // ─── Custom Horizontal Wander Slider (SvgSlider) ─────────────────────────────
@@ -997,17 +1903,17 @@ struct FugueWidget : ModuleWidget {
 			addParam(createParamCentered<VCVSlider>(mm2px(Vec(x, faderY)), module, Fugue::FADER_PARAM_0 + i));
 
 			// ── Gate toggle buttons (3 rows, all red) ──
-			int idxA = i * NUM_VOICES + 0;
+			int idxA = i * NUM_ROWS + 0;
 			addParam(createLightParamCentered<VCVLightLatch<MediumSimpleLight<RedLight>>>(
 				mm2px(Vec(x, gateRowY_A)), module,
 				Fugue::GATE_TOGGLE_PARAM_0 + idxA, Fugue::GATE_LIGHT_0 + idxA));
 
-			int idxB = i * NUM_VOICES + 1;
+			int idxB = i * NUM_ROWS + 1;
 			addParam(createLightParamCentered<VCVLightLatch<MediumSimpleLight<RedLight>>>(
 				mm2px(Vec(x, gateRowY_B)), module,
 				Fugue::GATE_TOGGLE_PARAM_0 + idxB, Fugue::GATE_LIGHT_0 + idxB));
 
-			int idxC = i * NUM_VOICES + 2;
+			int idxC = i * NUM_ROWS + 2;
 			addParam(createLightParamCentered<VCVLightLatch<MediumSimpleLight<RedLight>>>(
 				mm2px(Vec(x, gateRowY_C)), module,
 				Fugue::GATE_TOGGLE_PARAM_0 + idxC, Fugue::GATE_LIGHT_0 + idxC));
@@ -1024,7 +1930,7 @@ struct FugueWidget : ModuleWidget {
 		const int gateOutputs[] = {Fugue::GATE_A_OUTPUT, Fugue::GATE_B_OUTPUT, Fugue::GATE_C_OUTPUT};
 		const int cvOutputs[] = {Fugue::CV_A_OUTPUT, Fugue::CV_B_OUTPUT, Fugue::CV_C_OUTPUT};
 
-		for (int v = 0; v < NUM_VOICES; v++) {
+		for (int v = 0; v < NUM_ROWS; v++) {
 			float y = voiceYs[v];
 
 			// Clock input
@@ -1044,6 +1950,13 @@ struct FugueWidget : ModuleWidget {
 		}
 	}
 
+	void step() override {
+		ModuleWidget::step();
+		// Free Scala tunings the audio thread has let go of
+		Fugue* m = dynamic_cast<Fugue*>(this->module);
+		if (m) m->scalaTuning.pruneRetired();
+	}
+
 	// ── Context Menu ──
 	void appendContextMenu(Menu* menu) override {
 		Fugue* module = dynamic_cast<Fugue*>(this->module);
@@ -1066,18 +1979,134 @@ struct FugueWidget : ModuleWidget {
 		));
 
 		menu->addChild(new MenuSeparator);
+		std::vector<std::string> pageLabels;
+		for (int p = 0; p < NUM_PAGES; p++) {
+			pageLabels.push_back(string::f("%d-%d", p * NUM_STEPS + 1, (p + 1) * NUM_STEPS));
+		}
+		menu->addChild(createIndexSubmenuItem("Fader page", pageLabels,
+			[=]() { return (size_t)std::round(module->params[Fugue::PAGE_PARAM].getValue()); },
+			[=](size_t i) { module->params[Fugue::PAGE_PARAM].setValue((float)i); }
+		));
+		menu->addChild(createBoolPtrMenuItem("Page follows playhead", "",
+			&module->followPlayhead));
+
+		menu->addChild(new MenuSeparator);
+		std::shared_ptr<const Tuning> scala = module->scalaTuning.get();
+		menu->addChild(createSubmenuItem("Scala tuning", scala ? scala->name : "",
+			[=](Menu* menu) {
+				menu->addChild(createMenuItem("Load scale (.scl)...", "",
+					[=]() {
+						if (module->scalaTuning.loadDialog(false)) module->useScalaTuning = true;
+					}
+				));
+				menu->addChild(createMenuItem("Load keyboard mapping (.kbm)...", "",
+					[=]() { module->scalaTuning.loadDialog(true); },
+					module->scalaTuning.sclPath.empty()
+				));
+				menu->addChild(createBoolPtrMenuItem("Use instead of SCALE", "",
+					&module->useScalaTuning));
+				menu->addChild(createMenuItem("Clear", "",
+					[=]() {
+						module->scalaTuning.clear();
+						module->useScalaTuning = false;
+					},
+					module->scalaTuning.sclPath.empty()
+				));
+			}
+		));
+
+		std::vector<std::string> voiceLabels;
+		for (int n = NUM_ROWS; n <= MAX_VOICES; n++) {
+			voiceLabels.push_back(string::f("%d", n));
+		}
+		menu->addChild(createIndexSubmenuItem("Voices", voiceLabels,
+			[=]() { return (size_t)(module->numVoices - NUM_ROWS); },
+			[=](size_t i) { module->numVoices = NUM_ROWS + (int)i; }
+		));
 		menu->addChild(createBoolPtrMenuItem("Harmonic Lock", "",
 			&module->harmonicLock));
+		ui::Slider* strengthSlider = new ui::Slider;
+		strengthSlider->quantity = module->paramQuantities[Fugue::LOCK_STRENGTH_PARAM];
+		strengthSlider->box.size.x = 200.f;
+		menu->addChild(strengthSlider);
+
+		// Rendered on the look-ahead thread; asking now means the submenu,
+		// built on hover, shows the current controls
+		module->lookaheadWanted = true;
+		menu->addChild(createSubmenuItem("Upcoming notes", "",
+			[=](Menu* menu) {
+				const char* rowNames[] = {"A", "B", "C"};
+				int front = module->previewFront.load();
+				for (int r = 0; r < NUM_ROWS; r++) {
+					std::string line = string::f("%s:", rowNames[r]);
+					for (int i = 0; i < PREVIEW_STEPS; i++) {
+						float note = module->previewNotes[front][r][i];
+						line += " " + (std::isnan(note) ? std::string("-") : voltageToNoteName(note));
+					}
+					menu->addChild(createMenuLabel(line));
+				}
+			}
+		));
 
-		menu->addChild(new MenuSeparator);
-		menu->addChild(createMenuItem("Randomize Sequence", "",
-			[=]() {
-				for (int i = 0; i < NUM_STEPS; i++) {
-					module->params[Fugue::FADER_PARAM_0 + i].setValue(random::uniform());
+		uint32_t learned = module->markov.transitions();
+		menu->addChild(createSubmenuItem("Deviation model",
+			module->learnedDeviation ? "Learned" : "Fixed tiers",
+			[=](Menu* menu) {
+				menu->addChild(createCheckMenuItem("Fixed tiers", "",
+					[=]() { return !module->learnedDeviation; },
+					[=]() { module->learnedDeviation = false; }
+				));
+				menu->addChild(createCheckMenuItem("Learned", "",
+					[=]() { return module->learnedDeviation; },
+					[=]() { module->learnedDeviation = true; }
+				));
+				menu->addChild(new MenuSeparator);
+				menu->addChild(createBoolMenuItem("Learn from Root CV jack", "",
+					[=]() { return module->learnFromRootCv; },
+					[=](bool on) {
+						module->learnFromRootCv = on;
+						module->learnHeld = 0;
+					}
+				));
+				menu->addChild(createMenuLabel(string::f("%u transitions learned", learned)));
+				menu->addChild(createMenuItem("Clear learned model", "",
+					[=]() { module->markovClearWanted = true; },
+					learned == 0
+				));
+			}
+		));
+
+		menu->addChild(createSubmenuItem("Freeze phrase",
+			module->phrase.length > 0 ? string::f("%d steps", module->phrase.length) : "",
+			[=](Menu* menu) {
+				const int lengths[] = {4, 8, 16, 32, 64};
+				for (int n : lengths) {
+					menu->addChild(createMenuItem(string::f("Last %d steps", n), "",
+						[=]() { module->freezeHistory(n); }
+					));
 				}
+				menu->addChild(createMenuItem("Release (resume wandering)", "",
+					[=]() { module->releasePhrase(); },
+					module->phrase.length == 0
+				));
 			}
 		));
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createMenuItem("Randomize Sequence", "",
+			[=]() { module->randomizeWanted = true; }
+		));
 	}
 };
 
+FugueLink* fugueLink(Module* m) {
+	// Chains are short; the cap only guards against a malformed one
+	for (int hops = 0; m && hops < 64; hops++) {
+		if (m->model == modelFugue) return &static_cast<Fugue*>(m)->link;
+		if (!isFugueExpander(m)) return nullptr;
+		m = m->leftExpander.module;
+	}
+	return nullptr;
+}
+
 Model* modelFugue = createModel<Fugue, FugueWidget>("Fugue");
@@ -1,4 +1,22 @@
 #include "plugin.hpp"
+#include <osdialog.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+// Implementation lives in phase.cpp
+#include "dr_wav.h"
+
+using simd::float_4;
+
+
+// WAV file filter for open dialog
+static const char GSX_WAV_FILTERS[] = "WAV file (.wav):wav;All files (*.*):*";
+
+// Max sample length: 10 minutes at 48kHz
+static const size_t GSX_MAX_SAMPLE_LENGTH = 48000 * 60 * 10;
 
 
 struct Gsx : Module {
@@ -12,6 +30,7 @@ struct Gsx : Module {
 		PARAMDENSITY_PARAM,
 		PARAMVARIATION_PARAM,
 		PARAMSPREAD_PARAM,
+		SEED_PARAM,
 		PARAMS_LEN
 	};
 	enum InputId {
@@ -25,42 +44,21 @@ struct Gsx : Module {
 		INVARIATION_INPUT,
 		INSPREAD_INPUT,
 		INVCA_INPUT,
+		INAUDIO_INPUT,
 		INPUTS_LEN
 	};
 	enum OutputId {
 		OUTLEFT_OUTPUT,
 		OUTRIGHT_OUTPUT,
+		OUTLOAD_OUTPUT,
+		OUTSTREAMS_OUTPUT,
+		OUTONSETS_OUTPUT,
 		OUTPUTS_LEN
 	};
 	enum LightId {
 		LIGHTS_LEN
 	};
 
-	// Grain structure to track individual grain state
-	struct Grain {
-		bool active = false;           // Is this grain currently playing?
-		float envelopePhase = 0.f;     // Envelope phase (0-1 over grain lifetime)
-		float wavePhase = 0.f;         // Waveform phase (0-1, wraps for oscillation)
-		float frequency = 440.f;       // Grain frequency in Hz
-		float duration = 0.02f;        // Total grain duration in seconds
-		float pan = 0.5f;              // Stereo pan position (0=left, 1=right)
-
-		void reset() {
-			active = false;
-			envelopePhase = 0.f;
-			wavePhase = 0.f;
-		}
-
-		void trigger(float freq, float dur, float panPos) {
-			active = true;
-			envelopePhase = 0.f;
-			wavePhase = 0.f;
-			frequency = freq;
-			duration = dur;
-			pan = clamp(panPos, 0.f, 1.f);
-		}
-	};
-
 	// Hann window envelope function
 	// Takes normalized phase (0-1) and returns amplitude (0-1)
 	float hannWindow(float phase) {
@@ -69,63 +67,673 @@ struct Gsx : Module {
 		return 0.5f * (1.f - std::cos(2.f * M_PI * phase));
 	}
 
-	// Generate waveform sample at given phase with shape morphing
-	// phase: 0-1 normalized phase
-	// shape: 0-1 (0=sine, 0.33=tri, 0.66=saw, 1=square)
-	float generateGrainWave(float phase, float shape) {
+	// Hann window for four grains at once
+	static float_4 hannWindow4(float_4 phase) {
+		return 0.5f * (1.f - simd::cos(2.f * float(M_PI) * phase));
+	}
+
+	// Generate waveform samples for four grains with shape morphing
+	// phase: 0-1 normalized phase per grain
+	// shape: 0-1 (0=sine, 0.33=tri, 0.66=saw, 1=square), shared by the stream
+	// Only the two shapes being morphed between are computed.
+	static float_4 grainWave4(float_4 phase, float shape) {
 		// Sine wave
-		float sine = std::sin(phase * 2.f * M_PI);
+		auto sine = [&]() { return simd::sin(phase * 2.f * float(M_PI)); };
 
 		// Triangle wave: starts at 0, goes to +1 at 0.25, 0 at 0.5, -1 at 0.75, 0 at 1.0
-		float triangle;
-		if (phase < 0.25f) {
-			triangle = 4.f * phase;
-		} else if (phase < 0.75f) {
-			triangle = 2.f - 4.f * phase;
-		} else {
-			triangle = 4.f * phase - 4.f;
-		}
+		auto triangle = [&]() {
+			return simd::ifelse(phase < 0.25f, 4.f * phase,
+				simd::ifelse(phase < 0.75f, 2.f - 4.f * phase, 4.f * phase - 4.f));
+		};
 
 		// Sawtooth wave: ramps from 0 to +1 at 0.5, jumps to -1, ramps to 0 at 1.0
-		float sawtooth;
-		if (phase < 0.5f) {
-			sawtooth = 2.f * phase;
-		} else {
-			sawtooth = 2.f * phase - 2.f;
-		}
+		auto sawtooth = [&]() { return simd::ifelse(phase < 0.5f, 2.f * phase, 2.f * phase - 2.f); };
 
 		// Square wave
-		float square = (phase < 0.5f) ? 1.f : -1.f;
+		auto square = [&]() { return simd::ifelse(phase < 0.5f, float_4(1.f), float_4(-1.f)); };
 
 		// Morph between waveforms
 		if (shape <= 0.33f) {
 			// Sine to Triangle (0.0 to 0.33)
 			float mix = shape * 3.f;
-			return sine * (1.f - mix) + triangle * mix;
+			return sine() * (1.f - mix) + triangle() * mix;
 		}
 		else if (shape <= 0.66f) {
 			// Triangle to Sawtooth (0.33 to 0.66)
 			float mix = (shape - 0.33f) * 3.f;
-			return triangle * (1.f - mix) + sawtooth * mix;
+			return triangle() * (1.f - mix) + sawtooth() * mix;
 		}
 		else {
 			// Sawtooth to Square (0.66 to 1.0)
 			float mix = (shape - 0.66f) * 3.f;
-			return sawtooth * (1.f - mix) + square * mix;
+			return sawtooth() * (1.f - mix) + square() * mix;
 		}
 	}
 
+	// Per-stream random generator: xoshiro128+ run as four interleaved
+	// lanes, so one call yields the four uniforms a grain trigger needs.
+	// The lane loops are plain arrays and vectorize to SSE/NEON integer ops.
+	struct GrainRng {
+		uint32_t s0[4], s1[4], s2[4], s3[4];
+
+		static uint32_t splitmix32(uint32_t& x) {
+			uint32_t z = (x += 0x9E3779B9u);
+			z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+			z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+			return z ^ (z >> 16);
+		}
+
+		void seed(uint32_t seed) {
+			uint32_t x = seed;
+			for (int l = 0; l < 4; l++) {
+				s0[l] = splitmix32(x);
+				s1[l] = splitmix32(x);
+				s2[l] = splitmix32(x);
+				s3[l] = splitmix32(x) | 1u; // state must never be all zero
+			}
+		}
+
+		// Four uniforms in [0, 1)
+		void next(float out[4]) {
+			for (int l = 0; l < 4; l++) {
+				uint32_t result = s0[l] + s3[l];
+				uint32_t t = s1[l] << 9;
+				s2[l] ^= s0[l];
+				s3[l] ^= s1[l];
+				s1[l] ^= s2[l];
+				s0[l] ^= s3[l];
+				s2[l] ^= t;
+				s3[l] = (s3[l] << 11) | (s3[l] >> 21);
+				out[l] = (float)(result >> 8) * (1.f / 16777216.f);
+			}
+		}
+	};
+
+	// ─── Sample source ───────────────────────────────────────────────────────
+	// Grains can read from a loaded WAV or a ring buffer fed by the audio
+	// input instead of the internal oscillator. In those modes the Shape knob
+	// picks the read position, Range spreads it, and Frequency sets playback
+	// pitch relative to C3 (130.81 Hz = original speed).
+	enum SourceMode {
+		SOURCE_OSCILLATOR,
+		SOURCE_SAMPLE,
+		SOURCE_LIVE,
+	};
+	static constexpr float SOURCE_ROOT_FREQ = 130.81f;
+
+	// Decoded mono audio at its native rate. Never modified once published,
+	// so grains on any thread can read it without locking.
+	struct SampleBuffer {
+		std::vector<float> frames;
+		float sampleRate = 48000.f;
+
+		// Linear-interpolated read, wrapping around the end of the file
+		float read(double pos) const {
+			size_t length = frames.size();
+			double wrapped = pos - std::floor(pos / (double)length) * (double)length;
+			size_t i0 = (size_t)wrapped;
+			if (i0 >= length) i0 = 0;
+			size_t i1 = (i0 + 1 < length) ? i0 + 1 : 0;
+			float frac = (float)(wrapped - (double)i0);
+			return frames[i0] + (frames[i1] - frames[i0]) * frac;
+		}
+	};
+
+	int sourceMode = SOURCE_OSCILLATOR;
+	bool mixToStereo = false;      // sum polyphonic channels into one stereo pair
+	std::string samplePath;                       // UI thread only
+	std::atomic<SampleBuffer*> sampleBuffer{nullptr};
+
+	// Files decode on one loader thread. The UI thread only hands it a path,
+	// and a newer path supersedes one still decoding. A replaced buffer is
+	// freed once process() has run far enough past the swap that no control
+	// read or queued render block can still point at it.
+	static constexpr uint64_t SAMPLE_RELEASE_TICKS = 256;  // > longest control interval + one block
+
+	struct RetiredSample {
+		SampleBuffer* buffer;
+		uint64_t tick;         // processTicks when it was swapped out
+	};
+
+	std::thread loaderThread;
+	std::mutex loaderMutex;
+	std::condition_variable loaderCv;
+	std::string loaderPath;                       // guarded by loaderMutex
+	uint64_t loaderGeneration = 0;                // guarded by loaderMutex
+	bool loaderQuit = false;                      // guarded by loaderMutex
+	std::vector<RetiredSample> retiredSamples;    // loader thread only
+	std::atomic<uint64_t> processTicks{0};        // advanced once per process()
+
+	// Live input history, about 5.5 s at 48kHz. Positions are absolute frame
+	// counts, masked into the ring on read.
+	static constexpr int LIVE_BUFFER_FRAMES = 1 << 18;
+	std::vector<float> liveRing;
+	uint64_t liveFrames = 0;
+
+	float readLive(double pos) const {
+		double base = std::floor(pos);
+		// Via int64 so positions before the first frame wrap instead of overflowing
+		uint64_t i0 = (uint64_t)(int64_t)base;
+		float frac = (float)(pos - base);
+		float a = liveRing[i0 & (LIVE_BUFFER_FRAMES - 1)];
+		float b = liveRing[(i0 + 1) & (LIVE_BUFFER_FRAMES - 1)];
+		return a + (b - a) * frac;
+	}
+
+	// ─── Spatial output ──────────────────────────────────────────────────────
+	// Every grain feeds exactly two adjacent output channels with gains fixed
+	// at trigger: left/right of its voice in stereo, or a neighbouring pair of
+	// speakers in multichannel mode. Multichannel gains come from a lookup
+	// table indexed by the grain's position between the two speakers.
+	enum PanLaw {
+		PAN_RING,        // equal-power crossfade between neighbours
+		PAN_VBAP,        // 2D vector-base amplitude panning for a regular ring
+	};
+	static constexpr int PAN_TABLE_SIZE = 256;
+
+	struct PanPair {
+		uint8_t chanA = 0;
+		uint8_t chanB = 1;
+		float gainA = 0.f;
+		float gainB = 0.f;
+	};
+
+	int spatialChannels = 0;       // 0 = stereo, else 4/8/16 speakers (UI option)
+	int panLaw = PAN_RING;
+	int activeSpatial = -1;        // audio thread's applied layout
+	int activePanLaw = -1;
+	float panTableA[PAN_TABLE_SIZE + 1];
+	float panTableB[PAN_TABLE_SIZE + 1];
+
+	void buildPanTable(int speakers, int law) {
+		float spacing = 2.f * float(M_PI) / std::max(speakers, 3);
+		for (int i = 0; i <= PAN_TABLE_SIZE; i++) {
+			float frac = (float)i / PAN_TABLE_SIZE;
+			float a, b;
+			if (law == PAN_VBAP) {
+				// Solve for the gains that point the pair's summed vector at
+				// the source, then normalize to constant power
+				float angle = frac * spacing;
+				a = std::sin(spacing - angle) / std::sin(spacing);
+				b = std::sin(angle) / std::sin(spacing);
+				float norm = std::sqrt(a * a + b * b);
+				a /= norm;
+				b /= norm;
+			}
+			else {
+				a = std::cos(frac * 0.5f * float(M_PI));
+				b = std::sin(frac * 0.5f * float(M_PI));
+			}
+			panTableA[i] = a;
+			panTableB[i] = b;
+		}
+	}
+
+	// Position is in speakers around the ring, 0 = channel 1
+	PanPair spatialPan(float position, int speakers) const {
+		position -= std::floor(position / speakers) * speakers;
+		int speaker = std::min((int)position, speakers - 1);
+		float x = (position - speaker) * PAN_TABLE_SIZE;
+		int i = std::min((int)x, PAN_TABLE_SIZE - 1);
+		float t = x - i;
+		PanPair pan;
+		pan.chanA = (uint8_t)speaker;
+		pan.chanB = (uint8_t)((speaker + 1) % speakers);
+		pan.gainA = panTableA[i] + (panTableA[i + 1] - panTableA[i]) * t;
+		pan.gainB = panTableB[i] + (panTableB[i + 1] - panTableB[i]) * t;
+		return pan;
+	}
+
 	// Stream management
-	static constexpr int MAX_STREAMS = 20;
+	static constexpr int MAX_STREAMS = 20;       // per channel
 	static constexpr int GRAINS_PER_STREAM = 20; // Allow overlap of up to 20 grains per stream for dense textures
+	static constexpr int GRAIN_GROUPS = GRAINS_PER_STREAM / 4;
+	static constexpr int MAX_CHANNELS = 16;
+	// Streams are shared out between polyphonic channels: each channel gets
+	// a contiguous slice of STREAM_POOL / channels, capped by its Streams
+	// setting. Up to 3 channels get the full 20 streams each.
+	static constexpr int STREAM_POOL = 64;
 
+	// Grain slots are stored structure-of-arrays, four per float_4 group, so
+	// a stream renders four grains per instruction. Rates are per second
+	// rather than per sample so a grain can be rendered at any oversampling
+	// factor. A free slot has zero
+	// envelope phase and increments, so its Hann gain is 0 and it renders
+	// silence without any masking.
 	struct Stream {
-		Grain grains[GRAINS_PER_STREAM];
+		float_4 envPhase[GRAIN_GROUPS];    // Envelope phase (0-1 over grain lifetime)
+		float_4 envInc[GRAIN_GROUPS];      // Envelope phase per second (1 / duration)
+		float_4 wavePhase[GRAIN_GROUPS];   // Waveform phase (0-1, wraps for oscillation)
+		float_4 waveInc[GRAIN_GROUPS];     // Waveform phase per second (frequency)
+		float_4 gainA[GRAIN_GROUPS];       // Pan gain into output channel chanA
+		float_4 gainB[GRAIN_GROUPS];       // Pan gain into output channel chanB
+		float_4 fade[GRAIN_GROUPS];        // Steal fade gain (1 until stolen)
+		float_4 fadeInc[GRAIN_GROUPS];     // Fade per second, nonzero once stolen
+		double readPos[GRAINS_PER_STREAM]; // Source read position in frames (sample/live modes)
+		float readInc[GRAINS_PER_STREAM];  // Source frames advanced per second
+		uint8_t chanA[GRAINS_PER_STREAM];  // The two adjacent output channels
+		uint8_t chanB[GRAINS_PER_STREAM];  // this grain is panned between
+		uint32_t activeMask = 0;           // One bit per playing grain slot
+		float monoOut = 0.f;               // Unpanned sum for the Streams output
+		float onsetDur = 0.f;              // Length of a grain started this sample, else 0
 		float nextGrainTime = 0.f; // Time in seconds until next grain trigger
 		float phaseAccumulator = 0.f; // For tracking fractional samples
+		GrainRng rng;
+
+		Stream() {
+			resetGrains();
+		}
+
+		void resetGrains() {
+			for (int k = 0; k < GRAIN_GROUPS; k++) {
+				envPhase[k] = 0.f;
+				envInc[k] = 0.f;
+				wavePhase[k] = 0.f;
+				waveInc[k] = 0.f;
+				gainA[k] = 0.f;
+				gainB[k] = 0.f;
+				fade[k] = 1.f;
+				fadeInc[k] = 0.f;
+			}
+			for (int g = 0; g < GRAINS_PER_STREAM; g++) {
+				chanA[g] = 0;
+				chanB[g] = 1;
+			}
+			activeMask = 0;
+		}
+
+		void triggerGrain(int g, float freq, float dur, const PanPair& pan) {
+			int k = g >> 2;
+			int l = g & 3;
+			envPhase[k][l] = 0.f;
+			envInc[k][l] = 1.f / dur;
+			wavePhase[k][l] = 0.f;
+			waveInc[k][l] = freq;
+			gainA[k][l] = pan.gainA;
+			gainB[k][l] = pan.gainB;
+			chanA[g] = pan.chanA;
+			chanB[g] = pan.chanB;
+			fade[k][l] = 1.f;
+			fadeInc[k][l] = 0.f;
+			activeMask |= 1u << g;
+		}
+
+		float grainEnvPhase(int g) const {
+			return envPhase[g >> 2][g & 3];
+		}
 	};
 
-	Stream streams[MAX_STREAMS];
+	Stream streams[STREAM_POOL];
+
+	// First stream and stream count for channel c of `channels`
+	static void channelStreams(int channels, int c, int numStreams, int& first, int& count) {
+		int share = STREAM_POOL / channels;
+		first = c * share;
+		count = std::min(numStreams, share);
+	}
+
+	// Seed currently applied to the streams. -1 forces a reseed on the next
+	// sample; SEED_PARAM = 0 means "pick a fresh random seed".
+	int appliedSeed = -1;
+
+	struct SeedQuantity : ParamQuantity {
+		std::string getDisplayValueString() override {
+			int seed = (int)std::round(getValue());
+			return seed == 0 ? "Random" : string::f("%d", seed);
+		}
+	};
+
+	// Parameter snapshot for one channel and one sample. The per-sample path
+	// reads it and renders immediately; the block path queues BLOCK_SIZE of
+	// them per channel and renders the whole block at once.
+	struct GrainParams {
+		float centerFreq = 130.81f;
+		int numStreams = 10;
+		float shape = 0.f;
+		float range = 100.f;
+		float duration = 0.02f;
+		float delay = 0.01f;
+		float variation = 0.5f;
+		float spread = 0.5f;
+		float vcaGain = 1.f;
+		int source = SOURCE_OSCILLATOR;
+		const SampleBuffer* sample = nullptr;
+		double liveNow = 0.0;      // newest live frame written
+		float frameTime = 1.f / 48000.f;  // engine sample time (live frames)
+	};
+
+	// ─── Oversampling ────────────────────────────────────────────────────────
+	// Bright grains (saw/square shapes at high frequencies) alias at 44.1 or
+	// 48kHz. When enabled, the governor tick checks the highest active grain
+	// frequency against Nyquist and renders at 2x or 4x only while needed;
+	// the bus is brought back down by cascaded half-band decimators working
+	// on four bus channels per float_4.
+	//
+	// Each factor's path is delayed to the latency of the highest factor
+	// allowed, so a switch doesn't move the output in time. Every path up to
+	// the rendered factor is fed, the lower ones from the rendered sub-samples,
+	// so stepping down just takes the output from a path that is already
+	// running. Stepping up starts the new path, lets it fill, then fades
+	// across to it.
+	static constexpr int MAX_OVERSAMPLE = 4;
+	static constexpr int OVERSAMPLE_RELEASE_TICKS = 64;  // ~85ms at 48kHz before stepping down
+	static constexpr int OVERSAMPLE_WARM_FRAMES = 24;    // longest history a new path has to fill
+	static constexpr int OVERSAMPLE_FADE_FRAMES = 32;
+
+	// Polyphase half-band FIR (31 taps, Blackman window). All odd-offset taps
+	// except the centre are zero, so a 2:1 decimation needs the 16 even-phase
+	// taps plus one centre tap on a delayed odd-phase sample.
+	struct HalfBandDecimator {
+		static constexpr int TAPS = 16;
+		// The centre tap lands on x[2n - (TAPS - 2)], the earlier sample of
+		// the pair TAPS/2 - 1 pairs back. The ring reads before it writes, so
+		// its length is that delay.
+		static constexpr int CENTER_DELAY = TAPS / 2 - 1;
+		float_4 even[2 * TAPS];        // even-phase history, written twice for contiguous reads
+		float_4 odd[CENTER_DELAY];
+		int evenPos = 0;
+		int oddPos = 0;
+
+		struct Taps {
+			float h[TAPS];
+			Taps() {
+				const int length = 2 * TAPS - 1;
+				const int center = TAPS - 1;
+				float sum = 0.f;
+				for (int j = 0; j < TAPS; j++) {
+					int k = 2 * j;
+					float d = (float)(k - center);
+					float w = 0.42f - 0.5f * std::cos(2.f * float(M_PI) * (k + 1) / (length + 1))
+						+ 0.08f * std::cos(4.f * float(M_PI) * (k + 1) / (length + 1));
+					h[j] = std::sin(0.5f * float(M_PI) * d) / (float(M_PI) * d) * w;
+					sum += h[j];
+				}
+				// Unity DC gain: even taps sum to 0.5, centre tap adds 0.5
+				for (int j = 0; j < TAPS; j++) h[j] *= 0.5f / sum;
+			}
+		};
+
+		static const float* taps() {
+			static const Taps t;
+			return t.h;
+		}
+
+		// Fill the history with a constant so switching on doesn't start
+		// from silence
+		void reset(float_4 value) {
+			for (int i = 0; i < 2 * TAPS; i++) even[i] = value;
+			for (int i = 0; i < CENTER_DELAY; i++) odd[i] = value;
+			evenPos = 0;
+			oddPos = 0;
+		}
+
+		// Consume two input samples (earlier, later), return one
+		float_4 process(float_4 first, float_4 second) {
+			const float* h = taps();
+			evenPos = (evenPos + TAPS - 1) % TAPS;
+			even[evenPos] = second;
+			even[evenPos + TAPS] = second;
+			float_4 out = 0.f;
+			for (int j = 0; j < TAPS; j++) {
+				out += h[j] * even[evenPos + j];
+			}
+			float_4 delayed = odd[oddPos];
+			odd[oddPos] = first;
+			oddPos = (oddPos + 1) % CENTER_DELAY;
+			return out + 0.5f * delayed;
+		}
+	};
+
+	// Sub-sample 0 falls on the frame's own time, so the 2x decimator lags 7
+	// samples and the 4x cascade 10.5 (3.5 in the first stage, 7 in the
+	// second). A lower path waits out the difference: a whole number of
+	// samples, then optionally half a sample through the half-band's even
+	// taps, which interpolate flat over the band a lower factor is used for.
+	struct LatencyMatch {
+		static constexpr int LENGTH = 3 + HalfBandDecimator::TAPS;
+		float_4 history[2 * LENGTH];   // written twice for contiguous reads
+		int pos = 0;
+		int delay = 0;                 // whole samples
+		bool half = false;             // plus half a sample
+
+		void reset(float_4 value) {
+			for (int i = 0; i < 2 * LENGTH; i++) history[i] = value;
+			pos = 0;
+		}
+
+		float_4 process(float_4 x) {
+			pos = (pos + LENGTH - 1) % LENGTH;
+			history[pos] = x;
+			history[pos + LENGTH] = x;
+			if (!half) return history[pos + delay];
+			// The even taps sum to 0.5 and centre half way between taps 7 and 8
+			const float* h = HalfBandDecimator::taps();
+			float_4 out = 0.f;
+			for (int j = 0; j < HalfBandDecimator::TAPS; j++) {
+				out += h[j] * history[pos + delay + j];
+			}
+			return 2.f * out;
+		}
+	};
+
+	int oversampleLimit = 1;       // user option: 1 = off, 2 or 4
+	int oversample = 1;            // factor in use, changed at governor ticks
+	int oversampleHold = 0;        // ticks the lower factor has been enough
+	int latencyLimit = 1;          // oversampleLimit the paths are matched for
+	int outputFactor = 1;          // path the output is taken from
+	int fadeFrames = 0;            // frames since the rendered factor went above it
+	float engineSampleTime = 1.f / 48000.f;
+	float prevBus[2 * MAX_CHANNELS] = {};
+	HalfBandDecimator decimators[3][2 * MAX_CHANNELS / 4]; // [4x first stage, 4x second stage, 2x][bus group]
+	LatencyMatch latency1x[2 * MAX_CHANNELS / 4];          // [bus group]
+	LatencyMatch latency2x[2 * MAX_CHANNELS / 4];          // 2x sub-samples, before the decimator
+
+	// Highest audible partial relative to the fundamental for a Shape value
+	static float partialFactor(float shape) {
+		if (shape < 0.01f) return 1.f;     // pure sine
+		if (shape <= 0.33f) return 9.f;    // triangle: odd partials fall at 12 dB/oct
+		return 16.f;                       // saw/square: partials fall at 6 dB/oct
+	}
+
+	// ─── Control rate ────────────────────────────────────────────────────────
+	// Knobs and CVs are read every controlInterval samples rather than every
+	// sample. Values only used when a grain triggers (and Shape) glide towards
+	// the new reading with a one-pole filter; VCA ramps linearly across the
+	// interval so amplitude stays zipper-free. Pitch is never smoothed, so
+	// V/Oct and FM land exactly where they are sent. Patches saved before
+	// the option existed load at one read per sample, as they were made.
+	static constexpr float CONTROL_SMOOTH_TIME = 0.002f;
+	static constexpr int MAX_CONTROL_INTERVAL = 64;
+
+	int controlInterval = 32;      // user option, samples between reads
+	int controlCounter = 0;
+	int controlChannels = 0;       // 0 forces an unsmoothed read
+	GrainParams controlParams[MAX_CHANNELS];
+	float vcaStep[MAX_CHANNELS] = {};
+
+	void updateControls(int channels, float sampleTime) {
+		// New or removed voices jump straight to their settings
+		bool snap = (channels != controlChannels);
+		float a = snap ? 1.f : 1.f - std::exp(-controlInterval * sampleTime / CONTROL_SMOOTH_TIME);
+		for (int c = 0; c < channels; c++) {
+			if (snap) {
+				readParams(controlParams[c], c);
+				vcaStep[c] = 0.f;
+				continue;
+			}
+			GrainParams target;
+			readParams(target, c);
+			GrainParams& p = controlParams[c];
+			p.centerFreq = target.centerFreq;
+			p.shape += a * (target.shape - p.shape);
+			p.range += a * (target.range - p.range);
+			p.duration += a * (target.duration - p.duration);
+			p.delay += a * (target.delay - p.delay);
+			p.variation += a * (target.variation - p.variation);
+			p.spread += a * (target.spread - p.spread);
+			p.numStreams = target.numStreams;
+			p.source = target.source;
+			p.sample = target.sample;
+			p.frameTime = target.frameTime;
+			vcaStep[c] = (target.vcaGain - p.vcaGain) / controlInterval;
+		}
+		controlChannels = channels;
+	}
+
+	// Per-sample part of parameter handling: VCA ramp and live write head
+	void advanceControls(int channels, float sampleTime) {
+		if (controlInterval == 1) {
+			// Every sample: read straight into place, as before the option
+			// existed, with no smoothing or ramp to keep up
+			for (int c = 0; c < channels; c++) {
+				readParams(controlParams[c], c);
+			}
+			controlChannels = channels;
+			// A switch to a longer interval reads again on its first sample
+			controlCounter = MAX_CONTROL_INTERVAL;
+			return;
+		}
+		if (channels != controlChannels || ++controlCounter >= controlInterval) {
+			controlCounter = 0;
+			updateControls(channels, sampleTime);
+		}
+		else {
+			for (int c = 0; c < channels; c++) {
+				controlParams[c].vcaGain += vcaStep[c];
+			}
+		}
+		double liveNow = (double)liveFrames - 1.0;
+		for (int c = 0; c < channels; c++) {
+			controlParams[c].liveNow = liveNow;
+		}
+	}
+
+	float brightestShape() const {
+		float shape = 0.f;
+		for (int c = 0; c < controlChannels; c++) {
+			shape = std::max(shape, controlParams[c].shape);
+		}
+		return shape;
+	}
+
+	// ─── Block rendering ─────────────────────────────────────────────────────
+	// Optional mode for very dense clouds: parameters are queued for
+	// BLOCK_SIZE samples, then the block is rendered with streams shared out
+	// across a small worker pool. Output runs exactly BLOCK_SIZE samples late.
+	static constexpr int BLOCK_SIZE = 64;
+	static constexpr int MAX_WORKERS = 3; // helper threads, audio thread is slot 0
+	static constexpr int BLOCK_SPIN_LIMIT = 2000; // busy polls before yielding
+
+	// Output bus per sample: a left/right pair per voice in stereo, or one
+	// entry per speaker in multichannel mode
+	static constexpr int BUS_SIZE = 2 * MAX_CHANNELS;
+
+	struct WorkerAccum {
+		float bus[BLOCK_SIZE * MAX_OVERSAMPLE][BUS_SIZE];  // sub-samples of each sample in order
+		int active[BLOCK_SIZE][MAX_CHANNELS];
+	};
+
+	std::atomic<bool> blockRendering{false};   // user option, set from the UI thread
+	bool blockActive = false;      // audio thread's view of blockRendering
+	GrainParams blockParams[BLOCK_SIZE][MAX_CHANNELS];
+	int blockChannels[BLOCK_SIZE] = {};
+	float blockLeft[BLOCK_SIZE][MAX_CHANNELS] = {};
+	float blockRight[BLOCK_SIZE][MAX_CHANNELS] = {};
+	int blockOutChannels[BLOCK_SIZE] = {};
+	int blockRightChannels[BLOCK_SIZE] = {};
+	int blockPos = 0;
+	int blockStreams = 0;          // pool streams in use anywhere in the block, audio thread only
+	int blockOversample = 1;
+	float blockSampleTime = 1.f / 48000.f;
+	WorkerAccum accum[MAX_WORKERS + 1];
+
+	// Workers pull stream indices from a shared cursor, so a thread that
+	// finishes early simply takes the next stream instead of idling. The
+	// cursor packs the block's generation (high 32 bits), the slots whose
+	// partial sums it will mix, its stream count and the next unclaimed
+	// stream into one word, so a worker that wakes late, or one that was
+	// started mid-block, can only claim streams the block will use.
+	std::atomic<uint64_t> blockCursor{0};
+	uint32_t blockGeneration = 0;  // audio thread only
+	std::atomic<int> blockStreamsDone{0};
+	std::vector<std::thread> workers;          // UI thread only
+	std::atomic<int> workerCount{0};           // workers.size() for the audio thread
+	std::mutex workerMutex;
+	std::condition_variable workerCv;
+	std::atomic<uint64_t> workerGeneration{0};
+	bool workersQuit = false;                  // guarded by workerMutex
+
+	// ─── Stream outputs ──────────────────────────────────────────────────────
+	// The Streams output carries each stream's unpanned grains on its own
+	// channel, and Onsets fires a trigger (or a grain-length gate) on the
+	// matching channel whenever that stream starts a grain. Streams are
+	// numbered in voice order; only the first 16 get a channel.
+	static constexpr int MAX_STREAM_OUTPUTS = 16;
+
+	bool onsetGates = false;       // gates last the grain's duration instead of 1ms
+	dsp::PulseGenerator onsetPulses[MAX_STREAM_OUTPUTS];
+	int8_t blockStreamMap[BLOCK_SIZE][STREAM_POOL];
+	int blockStreamOutputs[BLOCK_SIZE] = {};
+	float blockStreamOut[BLOCK_SIZE][MAX_STREAM_OUTPUTS] = {};
+	float blockStreamOnset[BLOCK_SIZE][MAX_STREAM_OUTPUTS] = {};
+
+	// Map pool streams to output channels (-1 = none). Returns the channel count.
+	static int buildStreamMap(int channels, const GrainParams* params, int8_t* map) {
+		std::fill(map, map + STREAM_POOL, (int8_t)-1);
+		int n = 0;
+		for (int c = 0; c < channels; c++) {
+			int first, count;
+			channelStreams(channels, c, params[c].numStreams, first, count);
+			for (int s = first; s < first + count && n < MAX_STREAM_OUTPUTS; s++) {
+				map[s] = (int8_t)n++;
+			}
+		}
+		return n;
+	}
+
+	void writeStreamOutputs(const float* out, const float* onset, int n, float sampleTime) {
+		outputs[OUTSTREAMS_OUTPUT].setChannels(n);
+		outputs[OUTONSETS_OUTPUT].setChannels(n);
+		for (int i = 0; i < n; i++) {
+			outputs[OUTSTREAMS_OUTPUT].setVoltage(clamp(out[i], -10.f, 10.f), i);
+			if (onset[i] > 0.f) onsetPulses[i].trigger(onsetGates ? onset[i] : 1e-3f);
+			outputs[OUTONSETS_OUTPUT].setVoltage(onsetPulses[i].process(sampleTime) ? 10.f : 0.f, i);
+		}
+	}
+
+	// ─── CPU governor ────────────────────────────────────────────────────────
+	// Runs once per BLOCK_SIZE samples. When the active grain count exceeds
+	// the cap, the excess grains are stolen: they fade out over
+	// STEAL_FADE_TIME instead of being cut, so the cloud thins without clicks.
+	enum BudgetMode {
+		BUDGET_OFF,
+		BUDGET_GRAINS,   // fixed cap on concurrent grains
+		BUDGET_TIME,     // cap adapts to keep render time per block under budget
+	};
+	enum StealPolicy {
+		STEAL_OLDEST,
+		STEAL_QUIETEST,
+	};
+	static constexpr int MAX_GRAINS = STREAM_POOL * GRAINS_PER_STREAM;
+	static constexpr int MIN_GRAIN_CAP = 8;
+	static constexpr float STEAL_FADE_TIME = 0.002f;
+
+	int budgetMode = BUDGET_OFF;
+	int budgetGrains = 128;
+	float budgetMicros = 200.f;    // per BLOCK_SIZE samples
+	int stealPolicy = STEAL_OLDEST;
+
+	// Telemetry (written by the audio thread, read by the menu)
+	int grainCap = MAX_GRAINS;
+	int lastActiveGrains = 0;
+	float stealRate = 0.f;         // grains stolen per second, smoothed
+	float renderMicros = 0.f;      // render time of the last block, when measured
+	bool loadMeasured = false;
+
+	bool showRenderTime = false;   // measure even without a time budget
+
+	int governorCounter = 0;
+	double loadAccum = 0.0;
 
 	Gsx() {
 		config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -138,6 +746,9 @@ struct Gsx : Module {
 		configParam(PARAMDENSITY_PARAM, 1.f, 1000.f, 100.f, "Density", " grains/sec");
 		configParam(PARAMVARIATION_PARAM, 0.f, 1.f, 0.5f, "Variation", "%", 0.f, 100.f);
 		configParam(PARAMSPREAD_PARAM, 0.f, 1.f, 0.5f, "Spread", "%", 0.f, 100.f);
+		configParam<SeedQuantity>(SEED_PARAM, 0.f, 9999.f, 0.f, "Seed");
+		paramQuantities[SEED_PARAM]->snapEnabled = true;
+		paramQuantities[SEED_PARAM]->randomizeEnabled = false;
 		configInput(INFREQUENCY_INPUT, "Frequency CV");
 		configInput(INSTREAMS_INPUT, "Streams CV");
 		configInput(INSHAPE_INPUT, "Shape CV");
@@ -148,45 +759,703 @@ struct Gsx : Module {
 		configInput(INVARIATION_INPUT, "Variation CV");
 		configInput(INSPREAD_INPUT, "Spread CV");
 		configInput(INVCA_INPUT, "VCA CV");
+		configInput(INAUDIO_INPUT, "Audio (live source)");
 		configOutput(OUTLEFT_OUTPUT, "Left");
 		configOutput(OUTRIGHT_OUTPUT, "Right");
+		configOutput(OUTLOAD_OUTPUT, "Load telemetry (1: active grains, 40/V; 2: steals/sec, 100/V)");
+		configOutput(OUTSTREAMS_OUTPUT, "Streams (one channel per stream)");
+		configOutput(OUTONSETS_OUTPUT, "Grain onsets (one channel per stream)");
+		liveRing.assign(LIVE_BUFFER_FRAMES, 0.f);
 	}
 
-	void process(const ProcessArgs& args) override {
+	~Gsx() {
+		stopWorkers();
+		stopLoader();
+		delete sampleBuffer.load();
+		for (RetiredSample& r : retiredSamples) delete r.buffer;
+	}
+
+	void onReset() override {
+		setBlockRendering(false);
+		appliedSeed = -1;
+		budgetMode = BUDGET_OFF;
+		budgetGrains = 128;
+		budgetMicros = 200.f;
+		stealPolicy = STEAL_OLDEST;
+		setSourceMode(SOURCE_OSCILLATOR);
+		mixToStereo = false;
+		spatialChannels = 0;
+		panLaw = PAN_RING;
+		oversampleLimit = 1;
+		onsetGates = false;
+		controlInterval = 32;
+		showRenderTime = false;
+	}
+
+	// Restart every stream from a known state so a fixed seed renders the
+	// same cloud every time. Runs on the audio thread, between samples.
+	void reseedStreams(int seed) {
+		uint32_t base = (seed == 0) ? random::u32() : (uint32_t)seed;
+		for (int s = 0; s < STREAM_POOL; s++) {
+			Stream& stream = streams[s];
+			stream.resetGrains();
+			stream.nextGrainTime = 0.f;
+			stream.rng.seed(base * 0x9E3779B1u + (uint32_t)s * 0x85EBCA77u);
+		}
+		appliedSeed = seed;
+	}
+
+	json_t* dataToJson() override {
+		json_t* rootJ = json_object();
+		json_object_set_new(rootJ, "blockRendering", json_boolean(blockRendering.load()));
+		json_object_set_new(rootJ, "budgetMode", json_integer(budgetMode));
+		json_object_set_new(rootJ, "budgetGrains", json_integer(budgetGrains));
+		json_object_set_new(rootJ, "budgetMicros", json_real(budgetMicros));
+		json_object_set_new(rootJ, "stealPolicy", json_integer(stealPolicy));
+		json_object_set_new(rootJ, "sourceMode", json_integer(sourceMode));
+		json_object_set_new(rootJ, "mixToStereo", json_boolean(mixToStereo));
+		json_object_set_new(rootJ, "spatialChannels", json_integer(spatialChannels));
+		json_object_set_new(rootJ, "panLaw", json_integer(panLaw));
+		json_object_set_new(rootJ, "oversampleLimit", json_integer(oversampleLimit));
+		json_object_set_new(rootJ, "onsetGates", json_boolean(onsetGates));
+		json_object_set_new(rootJ, "controlInterval", json_integer(controlInterval));
+		json_object_set_new(rootJ, "showRenderTime", json_boolean(showRenderTime));
+		if (!samplePath.empty())
+			json_object_set_new(rootJ, "samplePath", json_string(samplePath.c_str()));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t* rootJ) override {
+		json_t* blockJ = json_object_get(rootJ, "blockRendering");
+		if (blockJ) setBlockRendering(json_boolean_value(blockJ));
+		json_t* modeJ = json_object_get(rootJ, "budgetMode");
+		if (modeJ) budgetMode = clamp((int)json_integer_value(modeJ), (int)BUDGET_OFF, (int)BUDGET_TIME);
+		json_t* grainsJ = json_object_get(rootJ, "budgetGrains");
+		if (grainsJ) budgetGrains = clamp((int)json_integer_value(grainsJ), (int)MIN_GRAIN_CAP, (int)MAX_GRAINS);
+		json_t* microsJ = json_object_get(rootJ, "budgetMicros");
+		if (microsJ) budgetMicros = clamp((float)json_number_value(microsJ), 10.f, 5000.f);
+		json_t* policyJ = json_object_get(rootJ, "stealPolicy");
+		if (policyJ) stealPolicy = clamp((int)json_integer_value(policyJ), (int)STEAL_OLDEST, (int)STEAL_QUIETEST);
+		json_t* mixJ = json_object_get(rootJ, "mixToStereo");
+		if (mixJ) mixToStereo = json_boolean_value(mixJ);
+		json_t* spatialJ = json_object_get(rootJ, "spatialChannels");
+		if (spatialJ) {
+			int speakers = (int)json_integer_value(spatialJ);
+			spatialChannels = (speakers == 4 || speakers == 8 || speakers == 16) ? speakers : 0;
+		}
+		json_t* lawJ = json_object_get(rootJ, "panLaw");
+		if (lawJ) panLaw = clamp((int)json_integer_value(lawJ), (int)PAN_RING, (int)PAN_VBAP);
+		json_t* intervalJ = json_object_get(rootJ, "controlInterval");
+		controlInterval = intervalJ ? clamp((int)json_integer_value(intervalJ), 1, (int)MAX_CONTROL_INTERVAL) : 1;
+		json_t* renderTimeJ = json_object_get(rootJ, "showRenderTime");
+		if (renderTimeJ) showRenderTime = json_boolean_value(renderTimeJ);
+		json_t* gatesJ = json_object_get(rootJ, "onsetGates");
+		if (gatesJ) onsetGates = json_boolean_value(gatesJ);
+		json_t* oversampleJ = json_object_get(rootJ, "oversampleLimit");
+		if (oversampleJ) {
+			int limit = (int)json_integer_value(oversampleJ);
+			oversampleLimit = (limit == 2 || limit == 4) ? limit : 1;
+		}
+		json_t* pathJ = json_object_get(rootJ, "samplePath");
+		if (pathJ) loadSampleAsync(json_string_value(pathJ));
+		json_t* sourceJ = json_object_get(rootJ, "sourceMode");
+		if (sourceJ) setSourceMode(clamp((int)json_integer_value(sourceJ), (int)SOURCE_OSCILLATOR, (int)SOURCE_LIVE));
+	}
+
+	// ─── Sample loading ──────────────────────────────────────────────────────
+
+	// Knob names follow the source so hover text and MIDI-map labels make sense
+	void setSourceMode(int mode) {
+		sourceMode = mode;
+		bool osc = (mode == SOURCE_OSCILLATOR);
+		ParamQuantity* shapeQ = paramQuantities[PARAMSHAPE_PARAM];
+		shapeQ->name = osc ? "Shape" : "Position";
+		shapeQ->unit = osc ? "" : "%";
+		shapeQ->displayMultiplier = osc ? 1.f : 100.f;
+		ParamQuantity* rangeQ = paramQuantities[PARAMRANGE_PARAM];
+		rangeQ->name = osc ? "Range" : "Position spread";
+		rangeQ->unit = osc ? " Hz" : "%";
+		rangeQ->displayMultiplier = osc ? 1.f : 0.2f;
+		paramQuantities[PARAMFREQUENCY_PARAM]->name = osc ? "Frequency" : "Pitch (C3 = original)";
+	}
+
+	static SampleBuffer* decodeWav(const std::string& path) {
+		drwav wav;
+		if (!drwav_init_file(&wav, path.c_str(), NULL))
+			return nullptr;
+
+		size_t totalFrames = wav.totalPCMFrameCount;
+		uint32_t channels = wav.channels;
+		if (totalFrames == 0 || channels == 0 || wav.sampleRate == 0) {
+			drwav_uninit(&wav);
+			return nullptr;
+		}
+		if (totalFrames > GSX_MAX_SAMPLE_LENGTH) totalFrames = GSX_MAX_SAMPLE_LENGTH;
+
+		std::vector<float> raw(totalFrames * channels);
+		totalFrames = drwav_read_pcm_frames_f32(&wav, totalFrames, raw.data());
+		float sampleRate = (float)wav.sampleRate;
+		drwav_uninit(&wav);
+		if (totalFrames == 0)
+			return nullptr;
+
+		// Mix down to mono
+		SampleBuffer* buffer = new SampleBuffer;
+		buffer->frames.resize(totalFrames);
+		for (size_t i = 0; i < totalFrames; i++) {
+			float sum = 0.f;
+			for (uint32_t ch = 0; ch < channels; ch++) {
+				sum += raw[i * channels + ch];
+			}
+			buffer->frames[i] = sum / (float)channels;
+		}
+		buffer->sampleRate = sampleRate;
+		return buffer;
+	}
+
+	// Queue a file for the loader thread and return straight away
+	void loadSampleAsync(const std::string& path) {
+		samplePath = path;
+		{
+			std::lock_guard<std::mutex> lock(loaderMutex);
+			loaderPath = path;
+			loaderGeneration++;
+		}
+		if (!loaderThread.joinable()) {
+			loaderThread = std::thread([this]() { loaderLoop(); });
+		}
+		loaderCv.notify_one();
+	}
+
+	void stopLoader() {
+		{
+			std::lock_guard<std::mutex> lock(loaderMutex);
+			loaderQuit = true;
+		}
+		loaderCv.notify_all();
+		if (loaderThread.joinable()) loaderThread.join();
+	}
+
+	void loaderLoop() {
+		uint64_t seen = 0;
+		while (true) {
+			std::string path;
+			{
+				std::unique_lock<std::mutex> lock(loaderMutex);
+				auto ready = [&]() { return loaderQuit || loaderGeneration != seen; };
+				// Buffers waiting to be freed need a look now and then
+				if (retiredSamples.empty())
+					loaderCv.wait(lock, ready);
+				else
+					loaderCv.wait_for(lock, std::chrono::milliseconds(50), ready);
+				if (loaderQuit) return;
+				if (loaderGeneration != seen) {
+					seen = loaderGeneration;
+					path = loaderPath;
+				}
+			}
+			releaseRetiredSamples();
+			if (path.empty()) continue;
+
+			SampleBuffer* buffer = decodeWav(path);
+			if (!buffer) continue;
+			bool superseded;
+			{
+				std::lock_guard<std::mutex> lock(loaderMutex);
+				superseded = (loaderGeneration != seen);
+			}
+			if (superseded) {
+				// A newer file was picked while this one decoded
+				delete buffer;
+				continue;
+			}
+			SampleBuffer* old = sampleBuffer.exchange(buffer);
+			if (old) retiredSamples.push_back({old, processTicks.load()});
+		}
+	}
+
+	void releaseRetiredSamples() {
+		uint64_t now = processTicks.load();
+		for (size_t i = 0; i < retiredSamples.size();) {
+			if (now - retiredSamples[i].tick > SAMPLE_RELEASE_TICKS) {
+				delete retiredSamples[i].buffer;
+				retiredSamples.erase(retiredSamples.begin() + i);
+			}
+			else {
+				i++;
+			}
+		}
+	}
+
+	void loadSampleDialog() {
+		osdialog_filters* filters = osdialog_filters_parse(GSX_WAV_FILTERS);
+		DEFER({ osdialog_filters_free(filters); });
+
+		std::string dir = samplePath.empty() ? "" : system::getDirectory(samplePath);
+		char* pathC = osdialog_file(OSDIALOG_OPEN, dir.empty() ? NULL : dir.c_str(), NULL, filters);
+		if (!pathC) return;
+
+		std::string path = pathC;
+		std::free(pathC);
+		loadSampleAsync(path);
+		setSourceMode(SOURCE_SAMPLE);
+	}
+
+	// ─── Worker pool ─────────────────────────────────────────────────────────
+
+	// Called from the UI thread (menu / patch load), never from process().
+	// Switching off stops the pool; a block already in flight finishes on
+	// the audio thread alone.
+	void setBlockRendering(bool enabled) {
+		if (enabled) startWorkers();
+		blockRendering = enabled;
+		if (!enabled) stopWorkers();
+	}
+
+	static int workerCountForMachine() {
+		int cores = (int)std::thread::hardware_concurrency();
+		// Leave the audio thread and at least one core for the rest of Rack
+		return clamp(cores - 2, 0, MAX_WORKERS);
+	}
+
+	void startWorkers() {
+		if (!workers.empty()) return;
+		int count = workerCountForMachine();
+		for (int w = 0; w < count; w++) {
+			workers.emplace_back([this, w]() { workerLoop(w + 1); });
+		}
+		workerCount = count;
+	}
+
+	// Blocks published after workerCount drops hand the workers nothing,
+	// so the join only waits for streams they already hold
+	void stopWorkers() {
+		if (workers.empty()) return;
+		workerCount = 0;
+		{
+			std::lock_guard<std::mutex> lock(workerMutex);
+			workersQuit = true;
+		}
+		workerCv.notify_all();
+		for (std::thread& t : workers) {
+			if (t.joinable()) t.join();
+		}
+		workers.clear();
+		std::lock_guard<std::mutex> lock(workerMutex);
+		workersQuit = false;
+	}
+
+	void workerLoop(int slot) {
+		uint64_t seen = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(workerMutex);
+				workerCv.wait(lock, [&]() { return workersQuit || workerGeneration.load() != seen; });
+				if (workersQuit) return;
+				seen = workerGeneration.load();
+			}
+			renderClaimedStreams(slot);
+		}
+	}
+
+	// Index of the next unrendered stream of the current block, or -1
+	int claimBlockStream(int slot) {
+		uint64_t cursor = blockCursor.load(std::memory_order_acquire);
+		while (true) {
+			int next = (int)(cursor & 0xFFF);
+			int count = (int)((cursor >> 12) & 0xFFF);
+			int slots = (int)((cursor >> 24) & 0xFF);
+			if (next >= count || slot >= slots) return -1;
+			if (blockCursor.compare_exchange_weak(cursor, cursor + 1,
+					std::memory_order_acq_rel, std::memory_order_acquire))
+				return next;
+		}
+	}
+
+	// Render whole streams for the current block until none are left.
+	// Each pool stream belongs to whichever channel owns its slice at that
+	// sample, so a channel count change mid-block is handled per sample.
+	void renderClaimedStreams(int slot) {
+		WorkerAccum& acc = accum[slot];
+		while (true) {
+			int s = claimBlockStream(slot);
+			if (s < 0) return;
+			Stream& stream = streams[s];
+			for (int i = 0; i < BLOCK_SIZE; i++) {
+				int channels = blockChannels[i];
+				int c = s / (STREAM_POOL / channels);
+				if (c >= channels) continue;
+				const GrainParams& p = blockParams[i][c];
+				int first, count;
+				channelStreams(channels, c, p.numStreams, first, count);
+				if (s >= first + count) continue;
+				int active = 0;
+				stream.monoOut = 0.f;
+				stream.onsetDur = 0.f;
+				for (int o = 0; o < blockOversample; o++) {
+					active = processStream(stream, p, blockSampleTime / blockOversample,
+						voiceBus(acc.bus[i * blockOversample + o], c));
+				}
+				acc.active[i][c] += active;
+
+				int out = blockStreamMap[i][s];
+				if (out >= 0) {
+					blockStreamOut[i][out] = stream.monoOut / blockOversample;
+					blockStreamOnset[i][out] = stream.onsetDur;
+				}
+			}
+			blockStreamsDone.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	void renderBlock() {
+		double startTime = system::getTime();
+		int slots = workerCount.load() + 1;
+		blockOversample = oversample;
+		std::memset(blockStreamOut, 0, sizeof(blockStreamOut));
+		std::memset(blockStreamOnset, 0, sizeof(blockStreamOnset));
+		for (int w = 0; w < slots; w++) {
+			std::memset(accum[w].bus, 0, sizeof(float) * BUS_SIZE * BLOCK_SIZE * blockOversample);
+			std::memset(accum[w].active, 0, sizeof(accum[w].active));
+		}
+
+		blockStreams = 0;
+		for (int i = 0; i < BLOCK_SIZE; i++) {
+			for (int c = 0; c < blockChannels[i]; c++) {
+				int first, count;
+				channelStreams(blockChannels[i], c, blockParams[i][c].numStreams, first, count);
+				blockStreams = std::max(blockStreams, first + count);
+			}
+		}
+		blockStreamsDone.store(0);
+		blockGeneration++;
+		blockCursor.store(((uint64_t)blockGeneration << 32) | ((uint64_t)slots << 24)
+			| ((uint64_t)blockStreams << 12), std::memory_order_release);
+
+		// No lock here: a worker that misses this wakeup sleeps through the
+		// block, and the audio thread renders its share below
+		if (slots > 1) {
+			workerGeneration.fetch_add(1);
+			workerCv.notify_all();
+		}
+
+		// The audio thread claims every stream no worker has, so all that is
+		// left to wait for is streams a worker is already part-way through.
+		// Spin briefly for those before giving up the time slice.
+		renderClaimedStreams(0);
+		for (int spin = 0; blockStreamsDone.load(std::memory_order_acquire) < blockStreams; spin++) {
+			if (spin >= BLOCK_SPIN_LIMIT) std::this_thread::yield();
+		}
+
+		// Mix per-worker partial sums
+		for (int i = 0; i < BLOCK_SIZE; i++) {
+			float sub[MAX_OVERSAMPLE][BUS_SIZE];
+			int active[MAX_CHANNELS];
+			for (int o = 0; o < blockOversample; o++) {
+				const int row = i * blockOversample + o;
+				for (int j = 0; j < BUS_SIZE; j++) {
+					sub[o][j] = 0.f;
+					for (int w = 0; w < slots; w++) sub[o][j] += accum[w].bus[row][j];
+				}
+			}
+			float bus[BUS_SIZE];
+			decimate(sub, blockOversample, bus);
+			for (int c = 0; c < blockChannels[i]; c++) {
+				active[c] = 0;
+				for (int w = 0; w < slots; w++) active[c] += accum[w].active[i][c];
+			}
+			blockOutChannels[i] = mixBus(bus, active, blockChannels[i],
+				blockLeft[i], blockRight[i], blockRightChannels[i]);
+		}
+
+		runGovernor(BLOCK_SIZE * blockSampleTime, system::getTime() - startTime, true);
+	}
+
+	// Bring `factor` sub-sample buses down to one output bus
+	void decimate(float sub[][BUS_SIZE], int factor, float* bus) {
+		if (latencyLimit == 1) {
+			std::memcpy(bus, sub[0], sizeof(float) * BUS_SIZE);
+		}
+		else {
+			float fade = 0.f;
+			if (outputFactor < factor) {
+				fadeFrames++;
+				fade = clamp((float)(fadeFrames - OVERSAMPLE_WARM_FRAMES) / OVERSAMPLE_FADE_FRAMES, 0.f, 1.f);
+			}
+			for (int g = 0; g < BUS_SIZE / 4; g++) {
+				float_4 out[3];   // by factor / 2: 1x, 2x, 4x
+				out[0] = latency1x[g].process(float_4::load(sub[0] + 4 * g));
+				if (factor >= 2) {
+					float_4 a = float_4::load(sub[0] + 4 * g);
+					float_4 b = float_4::load(sub[factor / 2] + 4 * g);
+					if (latencyLimit == 4) {
+						a = latency2x[g].process(a);
+						b = latency2x[g].process(b);
+					}
+					out[1] = decimators[2][g].process(a, b);
+				}
+				if (factor == 4) {
+					float_4 a = decimators[0][g].process(float_4::load(sub[0] + 4 * g), float_4::load(sub[1] + 4 * g));
+					float_4 b = decimators[0][g].process(float_4::load(sub[2] + 4 * g), float_4::load(sub[3] + 4 * g));
+					out[2] = decimators[1][g].process(a, b);
+				}
+				float_4 y = out[outputFactor / 2];
+				if (fade > 0.f) y += fade * (out[factor / 2] - y);
+				y.store(bus + 4 * g);
+			}
+			if (fadeFrames >= OVERSAMPLE_WARM_FRAMES + OVERSAMPLE_FADE_FRAMES) {
+				outputFactor = factor;
+				fadeFrames = 0;
+			}
+		}
+		std::memcpy(prevBus, bus, sizeof(prevBus));
+	}
+
+	// Pick the oversampling factor for the next window from the brightest
+	// grain now playing. Steps up at once, steps down only after the lower
+	// factor has been enough for OVERSAMPLE_RELEASE_TICKS.
+	void updateOversampling(float sampleTime) {
+		int needed = 1;
+		if (oversampleLimit > 1 && sourceMode == SOURCE_OSCILLATOR) {
+			float_4 maxFreq = 0.f;
+			for (int s = 0; s < STREAM_POOL; s++) {
+				if (!streams[s].activeMask) continue;
+				for (int k = 0; k < GRAIN_GROUPS; k++) {
+					maxFreq = simd::fmax(maxFreq, streams[s].waveInc[k]);
+				}
+			}
+			float highest = std::max(std::max(maxFreq[0], maxFreq[1]), std::max(maxFreq[2], maxFreq[3]))
+				* partialFactor(brightestShape());
+			// Leave room for the decimator's transition band
+			float usable = 0.45f / sampleTime;
+			while (needed < oversampleLimit && highest > usable * needed) needed *= 2;
+		}
+
+		// A new limit moves the latency every path is matched to, so they
+		// all start afresh at the factor needed now
+		if (oversampleLimit != latencyLimit) {
+			latencyLimit = oversampleLimit;
+			for (int g = 0; g < BUS_SIZE / 4; g++) {
+				float_4 last = float_4::load(prevBus + 4 * g);
+				latency1x[g].delay = (latencyLimit == 4) ? 3 : 7;
+				latency1x[g].half = (latencyLimit == 4);
+				latency1x[g].reset(last);
+				latency2x[g].delay = 7;
+				latency2x[g].reset(last);
+				for (int k = 0; k < 3; k++) decimators[k][g].reset(last);
+			}
+			oversample = outputFactor = needed;
+			oversampleHold = 0;
+			fadeFrames = 0;
+			return;
+		}
+
+		if (needed < oversample && ++oversampleHold < OVERSAMPLE_RELEASE_TICKS) return;
+		oversampleHold = 0;
+		if (needed == oversample) return;
+
+		if (needed > oversample) {
+			// Prime the paths that are switching on with the last output; the
+			// output stays where it is until they have filled
+			for (int g = 0; g < BUS_SIZE / 4; g++) {
+				float_4 last = float_4::load(prevBus + 4 * g);
+				if (oversample == 1) {
+					latency2x[g].reset(last);
+					decimators[2][g].reset(last);
+				}
+				if (needed == 4) {
+					decimators[0][g].reset(last);
+					decimators[1][g].reset(last);
+				}
+			}
+			fadeFrames = 0;
+		}
+		else {
+			outputFactor = std::min(outputFactor, needed);
+		}
+		oversample = needed;
+	}
+
+	// Where voice c's grains land on the output bus
+	float* voiceBus(float* bus, int c) const {
+		return activeSpatial > 0 ? bus : bus + 2 * c;
+	}
+
+	// Apply the grain-count gain to the bus and clamp it into the output
+	// arrays. Stereo gives each voice its own gain and can sum voices to one
+	// pair; multichannel mixes all voices into the speaker channels on Left.
+	// Returns the Left channel count. Also updates lastActiveGrains.
+	int mixBus(const float* bus, const int* active, int channels, float* outLeft, float* outRight, int& rightChannels) {
+		int total = 0;
+		for (int c = 0; c < channels; c++) total += active[c];
+		lastActiveGrains = total;
+
+		if (activeSpatial > 0) {
+			float gain = outputGain(total);
+			for (int s = 0; s < activeSpatial; s++) {
+				outLeft[s] = clamp(bus[s] * gain, -10.f, 10.f);
+			}
+			rightChannels = 0;
+			return activeSpatial;
+		}
+
+		float sumLeft = 0.f;
+		float sumRight = 0.f;
+		for (int c = 0; c < channels; c++) {
+			float gain = outputGain(active[c]);
+			float left = bus[2 * c] * gain;
+			float right = bus[2 * c + 1] * gain;
+			if (mixToStereo) {
+				sumLeft += left;
+				sumRight += right;
+			}
+			else {
+				outLeft[c] = clamp(left, -10.f, 10.f);
+				outRight[c] = clamp(right, -10.f, 10.f);
+			}
+		}
+		if (mixToStereo) {
+			outLeft[0] = clamp(sumLeft, -10.f, 10.f);
+			outRight[0] = clamp(sumRight, -10.f, 10.f);
+			channels = 1;
+		}
+		rightChannels = channels;
+		return channels;
+	}
+
+	void writeOutputs(const float* left, const float* right, int leftChannels, int rightChannels) {
+		outputs[OUTLEFT_OUTPUT].setChannels(leftChannels);
+		outputs[OUTRIGHT_OUTPUT].setChannels(rightChannels);
+		for (int c = 0; c < leftChannels; c++) {
+			outputs[OUTLEFT_OUTPUT].setVoltage(left[c], c);
+		}
+		for (int c = 0; c < rightChannels; c++) {
+			outputs[OUTRIGHT_OUTPUT].setVoltage(right[c], c);
+		}
+	}
+
+	// ─── Governor ────────────────────────────────────────────────────────────
+
+	// Update the grain cap from the last window's load, then steal any
+	// grains above it. windowTime is BLOCK_SIZE samples in seconds.
+	void runGovernor(float windowTime, double renderSeconds, bool measured) {
+		loadMeasured = measured;
+		if (measured) renderMicros = (float)(renderSeconds * 1e6);
+
+		switch (budgetMode) {
+			case BUDGET_GRAINS:
+				grainCap = budgetGrains;
+				break;
+			case BUDGET_TIME:
+				if (renderMicros > budgetMicros) {
+					// Scale the cap by how far over budget the last block was
+					int scaled = (int)(lastActiveGrains * budgetMicros / renderMicros);
+					grainCap = clamp(std::min(scaled, grainCap), (int)MIN_GRAIN_CAP, (int)MAX_GRAINS);
+				}
+				else if (renderMicros < budgetMicros * 0.8f) {
+					// Comfortably under: let the cloud grow back gradually
+					grainCap = std::min(grainCap + grainCap / 8 + 1, (int)MAX_GRAINS);
+				}
+				break;
+			default:
+				grainCap = MAX_GRAINS;
+				break;
+		}
+
+		updateOversampling(windowTime / BLOCK_SIZE);
+
+		int stolen = (lastActiveGrains > grainCap)
+			? stealGrains(lastActiveGrains - grainCap) : 0;
+		float rate = (float)stolen / windowTime;
+		stealRate += (rate - stealRate) * std::min(1.f, windowTime / 0.5f);
+	}
+
+	// Bring the cloud down by `excess` grains: mark that many for a short
+	// fade-out, less the ones still fading from earlier steals (they're in
+	// lastActiveGrains until they finish, and the fade outlasts a tick).
+	// Picks the oldest (furthest through their envelope) or quietest (lowest
+	// envelope now).
+	int stealGrains(int excess) {
+		struct Candidate {
+			Stream* stream;
+			int slot;
+			float score;   // lower = steal first
+		};
+		Candidate candidates[MAX_GRAINS];
+		int n = 0;
+		int fading = 0;
+		for (int s = 0; s < STREAM_POOL; s++) {
+			Stream& stream = streams[s];
+			for (int g = 0; g < GRAINS_PER_STREAM; g++) {
+				if (!(stream.activeMask & (1u << g))) continue;
+				if (stream.fadeInc[g >> 2][g & 3] > 0.f) {
+					fading++;   // already stolen
+					continue;
+				}
+				float phase = stream.grainEnvPhase(g);
+				float score = (stealPolicy == STEAL_QUIETEST) ? hannWindow(phase) : -phase;
+				candidates[n++] = {&stream, g, score};
+			}
+		}
+		int count = std::min(excess - fading, n);
+		if (count <= 0) return 0;
+		std::nth_element(candidates, candidates + count - 1, candidates + n,
+			[](const Candidate& a, const Candidate& b) { return a.score < b.score; });
+		float fadeInc = 1.f / STEAL_FADE_TIME;
+		for (int i = 0; i < count; i++) {
+			int g = candidates[i].slot;
+			candidates[i].stream->fadeInc[g >> 2][g & 3] = fadeInc;
+		}
+		return count;
+	}
+
+	void writeTelemetry() {
+		if (!outputs[OUTLOAD_OUTPUT].isConnected()) return;
+		outputs[OUTLOAD_OUTPUT].setChannels(2);
+		outputs[OUTLOAD_OUTPUT].setVoltage(clamp(lastActiveGrains / 40.f, 0.f, 10.f), 0);
+		outputs[OUTLOAD_OUTPUT].setVoltage(clamp(stealRate / 100.f, 0.f, 10.f), 1);
+	}
+
+	// Read channel c. Each CV input is polyphonic; a mono CV applies to
+	// every channel.
+	void readParams(GrainParams& p, int c) {
 		// Read parameters with CV inputs
 		float centerFreq = std::pow(2.f, params[PARAMFREQUENCY_PARAM].getValue());
 		if (inputs[INFREQUENCY_INPUT].isConnected()) {
-			centerFreq *= std::pow(2.f, inputs[INFREQUENCY_INPUT].getVoltage());
+			centerFreq *= std::pow(2.f, inputs[INFREQUENCY_INPUT].getPolyVoltage(c));
 		}
-		centerFreq = clamp(centerFreq, 50.f, 2000.f);
+		p.centerFreq = clamp(centerFreq, 50.f, 2000.f);
 
 		int numStreams = (int)std::round(params[PARAMSTREAMS_PARAM].getValue());
 		if (inputs[INSTREAMS_INPUT].isConnected()) {
 			numStreams = (int)std::round(clamp(params[PARAMSTREAMS_PARAM].getValue() +
-				inputs[INSTREAMS_INPUT].getVoltage() * 2.f, 1.f, 20.f));
+				inputs[INSTREAMS_INPUT].getPolyVoltage(c) * 2.f, 1.f, 20.f));
 		}
-		numStreams = clamp(numStreams, 1, MAX_STREAMS);
+		p.numStreams = clamp(numStreams, 1, MAX_STREAMS);
 
 		float shape = params[PARAMSHAPE_PARAM].getValue();
 		if (inputs[INSHAPE_INPUT].isConnected()) {
-			shape = clamp(shape + inputs[INSHAPE_INPUT].getVoltage() / 5.f, 0.f, 1.f);
+			shape = clamp(shape + inputs[INSHAPE_INPUT].getPolyVoltage(c) / 5.f, 0.f, 1.f);
 		}
+		p.shape = shape;
 
 		float range = params[PARAMRANGE_PARAM].getValue();
 		if (inputs[INRANGE_INPUT].isConnected()) {
-			range = clamp(range + inputs[INRANGE_INPUT].getVoltage() * 100.f, 0.f, 500.f);
+			range = clamp(range + inputs[INRANGE_INPUT].getPolyVoltage(c) * 100.f, 0.f, 500.f);
 		}
+		p.range = range;
 
 		float duration = params[PARAMDURATION_PARAM].getValue() / 1000.f; // Convert ms to seconds
 		if (inputs[INDURATION_INPUT].isConnected()) {
 			duration = clamp((params[PARAMDURATION_PARAM].getValue() +
-				inputs[INDURATION_INPUT].getVoltage() * 20.f) / 1000.f, 0.001f, 0.1f);
+				inputs[INDURATION_INPUT].getPolyVoltage(c) * 20.f) / 1000.f, 0.001f, 0.1f);
 		}
+		p.duration = duration;
 
 		float density = params[PARAMDENSITY_PARAM].getValue();
 		if (inputs[INDENSITY_INPUT].isConnected()) {
 			density = clamp(params[PARAMDENSITY_PARAM].getValue() +
-				inputs[INDENSITY_INPUT].getVoltage() * 200.f, 1.f, 1000.f);
+				inputs[INDENSITY_INPUT].getPolyVoltage(c) * 200.f, 1.f, 1000.f);
 		}
 
 		// Always use Density as primary timing control (grains/sec -> seconds between grains)
@@ -196,163 +1465,380 @@ struct Gsx : Module {
 		float delayOffset = params[PARAMDELAY_PARAM].getValue() / 1000.f; // Convert ms to seconds
 		if (inputs[INDELAY_INPUT].isConnected()) {
 			delayOffset = clamp((params[PARAMDELAY_PARAM].getValue() +
-				inputs[INDELAY_INPUT].getVoltage() * 40.f) / 1000.f, 0.0001f, 0.2f);
+				inputs[INDELAY_INPUT].getPolyVoltage(c) * 40.f) / 1000.f, 0.0001f, 0.2f);
 		}
 
 		// Add delay offset if specified (allows manual override when Delay knob is turned up)
 		if (delayOffset > 0.0002f) {  // Greater than 0.2ms = using Delay control
 			delay = delayOffset;
 		}
+		p.delay = delay;
 
 		float variation = params[PARAMVARIATION_PARAM].getValue();
 		if (inputs[INVARIATION_INPUT].isConnected()) {
-			variation = clamp(variation + inputs[INVARIATION_INPUT].getVoltage() / 5.f, 0.f, 1.f);
+			variation = clamp(variation + inputs[INVARIATION_INPUT].getPolyVoltage(c) / 5.f, 0.f, 1.f);
 		}
+		p.variation = variation;
 
 		float spread = params[PARAMSPREAD_PARAM].getValue();
 		if (inputs[INSPREAD_INPUT].isConnected()) {
-			spread = clamp(spread + inputs[INSPREAD_INPUT].getVoltage() / 5.f, 0.f, 1.f);
+			spread = clamp(spread + inputs[INSPREAD_INPUT].getPolyVoltage(c) / 5.f, 0.f, 1.f);
 		}
+		p.spread = spread;
 
 		// Read VCA input (0-5V = 0-1 gain, linear VCA)
 		float vcaGain = 1.f;
 		if (inputs[INVCA_INPUT].isConnected()) {
-			vcaGain = clamp(inputs[INVCA_INPUT].getVoltage() / 5.f, 0.f, 1.f);
+			vcaGain = clamp(inputs[INVCA_INPUT].getPolyVoltage(c) / 5.f, 0.f, 1.f);
+		}
+		p.vcaGain = vcaGain;
+
+		// Without a loaded file, sample mode falls back to the oscillator
+		p.sample = sampleBuffer.load(std::memory_order_acquire);
+		p.source = sourceMode;
+		if (p.source == SOURCE_SAMPLE && !p.sample) p.source = SOURCE_OSCILLATOR;
+		p.liveNow = (double)liveFrames - 1.0;
+		p.frameTime = engineSampleTime;
+	}
+
+	// Intelligent gain scaling based on active grain count
+	// More grains = lower gain to prevent clipping
+	// Fewer grains = higher gain to maintain presence
+	static float outputGain(int activeGrainCount) {
+		if (activeGrainCount <= 0) return 1.f;
+		// Scale from 1.0 (1 grain) to 0.15 (100+ grains) using logarithmic curve
+		return clamp(1.0f / std::sqrt((float)activeGrainCount * 0.5f), 0.15f, 1.0f);
+	}
+
+	// Place a new grain's read head. `jitter` is the trigger's uniform that
+	// the oscillator would spend on frequency variation.
+	void startSourceRead(Stream& stream, int g, float grainDur, const GrainParams& p, float jitter) {
+		float ratio = p.centerFreq / SOURCE_ROOT_FREQ;
+		float variationScale = (p.variation < 0.3f) ? p.variation * p.variation / 0.3f : p.variation;
+		float position = p.shape + (jitter - 0.5f) * 2.f * (p.range / 500.f) * variationScale;
+
+		if (p.source == SOURCE_SAMPLE) {
+			position -= std::floor(position); // wrap into the file
+			stream.readPos[g] = (double)position * (double)p.sample->frames.size();
+			stream.readInc[g] = ratio * p.sample->sampleRate;
+			return;
 		}
 
-		// Initialize output accumulators
-		float leftOut = 0.f;
-		float rightOut = 0.f;
+		// Live: position is how far back from the newest frame to start.
+		// Keep the read head behind the write head for the whole grain, and
+		// ahead of the frames the write head will overwrite.
+		float grainFrames = grainDur / p.frameTime;
+		float minLag = std::max(0.f, grainFrames * (ratio - 1.f)) + 2.f;
+		float maxLag = (float)LIVE_BUFFER_FRAMES - std::max(0.f, grainFrames * (1.f - ratio)) - 4.f;
+		float lag = minLag + clamp(position, 0.f, 1.f) * std::max(0.f, maxLag - minLag);
+		stream.readPos[g] = p.liveNow - (double)lag;
+		stream.readInc[g] = ratio / p.frameTime;
+	}
+
+	// Advance one stream by one sample: trigger a grain if due, then render
+	// its active grains into `bus` (this voice's slice of the output bus).
+	// Returns the active grain count.
+	// Touches only this stream's state, so streams can run on any thread.
+	int processStream(Stream& stream, const GrainParams& p, float sampleTime, float* bus) {
 		int activeGrainCount = 0;
 
-		// Process each active stream
-		for (int s = 0; s < numStreams; s++) {
-			Stream& stream = streams[s];
+		// Decrement grain timer
+		stream.nextGrainTime -= sampleTime;
 
-			// Decrement grain timer
-			stream.nextGrainTime -= args.sampleTime;
-
-			// Trigger new grain if timer expired
-			if (stream.nextGrainTime <= 0.f) {
-				// Find available grain slot
-				for (int g = 0; g < GRAINS_PER_STREAM; g++) {
-					if (!stream.grains[g].active) {
-						// Calculate grain frequency with variation
-						// Range defines frequency bandwidth, Variation controls randomness amount
-						float grainFreq = centerFreq;
-						if (variation > 0.01f && range > 0.f) {
-							// Use linear variation for Range (for predictable control)
-							// But square variation for tighter control at very low values
-							float variationScale = (variation < 0.3f) ? variation * variation / 0.3f : variation;
-							float freqOffset = (random::uniform() - 0.5f) * 2.f * range * variationScale;
-							grainFreq += freqOffset;
-						}
-						grainFreq = clamp(grainFreq, 20.f, 20000.f);
-
-						// Calculate grain duration with variation
-						// Quasi-synchronous mode benefits from consistent grain duration
-						float grainDur = duration;
-						if (variation > 0.01f) {
-							// Reduced duration variation for better quasi-synchronous behavior
-							float variationScale = variation * variation;
-							float durVariation = (random::uniform() - 0.5f) * 2.f * variationScale * 0.3f;
-							grainDur *= (1.f + durVariation);
-						}
-						grainDur = clamp(grainDur, 0.001f, 0.2f);
-
-						// Calculate pan position with spread
-						// Each grain gets random pan position across the stereo field
-						float panPos = 0.5f; // Center by default
-						if (spread > 0.01f) {
-							// Random pan position with dramatic stereo spread
-							// Push distribution toward extremes (hard left/right) at high spread values
-							float randomPan = random::uniform(); // 0 to 1
-
-							// Apply square root curve to bias toward extremes
-							// Normalize to -1 to 1, apply sqrt, scale back
-							float offset = randomPan - 0.5f; // -0.5 to 0.5
-							float sign = (offset >= 0.f) ? 1.f : -1.f;
-							float normalized = std::abs(offset) * 2.f; // 0 to 1
-							float pushed = std::sqrt(normalized) * 0.5f * sign; // -0.5 to 0.5, biased toward extremes
-
-							panPos = 0.5f + pushed * spread;
-							panPos = clamp(panPos, 0.f, 1.f);
-						}
-
-						// Trigger the grain
-						stream.grains[g].trigger(grainFreq, grainDur, panPos);
-						break;
+		// Trigger new grain if timer expired
+		if (stream.nextGrainTime <= 0.f) {
+			// One batch of uniforms per trigger: frequency, duration, pan and
+			// next delay. Drawn even if unused so the sequence stays fixed.
+			float u[4];
+			stream.rng.next(u);
+
+			// Find available grain slot
+			for (int g = 0; g < GRAINS_PER_STREAM; g++) {
+				if (!(stream.activeMask & (1u << g))) {
+					// Calculate grain frequency with variation
+					// Range defines frequency bandwidth, Variation controls randomness amount
+					// (sampled sources use Range for position spread instead)
+					float grainFreq = p.centerFreq;
+					if (p.source == SOURCE_OSCILLATOR && p.variation > 0.01f && p.range > 0.f) {
+						// Use linear variation for Range (for predictable control)
+						// But square variation for tighter control at very low values
+						float variationScale = (p.variation < 0.3f) ? p.variation * p.variation / 0.3f : p.variation;
+						float freqOffset = (u[0] - 0.5f) * 2.f * p.range * variationScale;
+						grainFreq += freqOffset;
 					}
-				}
+					grainFreq = clamp(grainFreq, 20.f, 20000.f);
 
-				// Schedule next grain with delay and variation
-				// Quasi-synchronous mode requires tighter timing control
-				float nextDelay = delay;
-				if (variation > 0.01f && nextDelay > 0.f) {
-					// Use exponential scaling for timing variation too
-					float variationScale = variation * variation;
-					float delayVariation = (random::uniform() - 0.5f) * 2.f * variationScale;
-					nextDelay *= (1.f + delayVariation);
+					// Calculate grain duration with variation
+					// Quasi-synchronous mode benefits from consistent grain duration
+					float grainDur = p.duration;
+					if (p.variation > 0.01f) {
+						// Reduced duration variation for better quasi-synchronous behavior
+						float variationScale = p.variation * p.variation;
+						float durVariation = (u[1] - 0.5f) * 2.f * variationScale * 0.3f;
+						grainDur *= (1.f + durVariation);
+					}
+					grainDur = clamp(grainDur, 0.001f, 0.2f);
+
+					// Calculate pan position with spread
+					// Each grain gets random pan position across the stereo field
+					float panPos = 0.5f; // Center by default
+					if (activeSpatial > 0) {
+						// Around the speaker ring, centred on channel 1;
+						// full spread reaches every speaker
+						panPos = (u[2] - 0.5f) * p.spread * activeSpatial;
+					}
+					else if (p.spread > 0.01f) {
+						// Random pan position with dramatic stereo spread
+						// Push distribution toward extremes (hard left/right) at high spread values
+						float randomPan = u[2]; // 0 to 1
+
+						// Apply square root curve to bias toward extremes
+						// Normalize to -1 to 1, apply sqrt, scale back
+						float offset = randomPan - 0.5f; // -0.5 to 0.5
+						float sign = (offset >= 0.f) ? 1.f : -1.f;
+						float normalized = std::abs(offset) * 2.f; // 0 to 1
+						float pushed = std::sqrt(normalized) * 0.5f * sign; // -0.5 to 0.5, biased toward extremes
+
+						panPos = 0.5f + pushed * p.spread;
+						panPos = clamp(panPos, 0.f, 1.f);
+					}
+
+					// Pan gains are fixed for the grain's life, so work them out once
+					PanPair pan;
+					if (activeSpatial > 0) {
+						pan = spatialPan(panPos, activeSpatial);
+					}
+					else {
+						// Equal-power stereo
+						pan.gainA = std::sqrt(1.f - panPos);
+						pan.gainB = std::sqrt(panPos);
+					}
+
+					// Trigger the grain
+					stream.triggerGrain(g, grainFreq, grainDur, pan);
+					stream.onsetDur = grainDur;
+					if (p.source != SOURCE_OSCILLATOR) {
+						startSourceRead(stream, g, grainDur, p, u[0]);
+					}
+					break;
 				}
-				stream.nextGrainTime = std::max(0.001f, nextDelay);
 			}
 
-			// Process all active grains in this stream
-			for (int g = 0; g < GRAINS_PER_STREAM; g++) {
-				Grain& grain = stream.grains[g];
-				if (!grain.active) continue;
+			// Schedule next grain with delay and variation
+			// Quasi-synchronous mode requires tighter timing control
+			float nextDelay = p.delay;
+			if (p.variation > 0.01f && nextDelay > 0.f) {
+				// Use exponential scaling for timing variation too
+				float variationScale = p.variation * p.variation;
+				float delayVariation = (u[3] - 0.5f) * 2.f * variationScale;
+				nextDelay *= (1.f + delayVariation);
+			}
+			stream.nextGrainTime = std::max(0.001f, nextDelay);
+		}
 
-				activeGrainCount++;
+		// Process all active grains in this stream, four slots at a time
+		float_4 mono = 0.f;
+		for (int k = 0; k < GRAIN_GROUPS; k++) {
+			uint32_t groupMask = (stream.activeMask >> (k * 4)) & 0xFu;
+			if (!groupMask) continue;
 
-				// Generate grain sample
-				float grainSample = generateGrainWave(grain.wavePhase, shape);
+			activeGrainCount += __builtin_popcount(groupMask);
 
-				// Apply envelope
-				float envelope = hannWindow(grain.envelopePhase);
-				grainSample *= envelope;
+			// Generate grain samples
+			float_4 grainSample;
+			if (p.source == SOURCE_OSCILLATOR) {
+				grainSample = grainWave4(stream.wavePhase[k], p.shape);
+			}
+			else {
+				grainSample = 0.f;
+				for (int l = 0; l < 4; l++) {
+					if (!(groupMask & (1u << l))) continue;
+					int g = k * 4 + l;
+					grainSample[l] = (p.source == SOURCE_SAMPLE)
+						? p.sample->read(stream.readPos[g])
+						: readLive(stream.readPos[g]);
+					stream.readPos[g] += stream.readInc[g] * sampleTime;
+				}
+			}
 
-				// Apply stereo panning (equal-power)
-				float leftGain = std::sqrt(1.f - grain.pan);
-				float rightGain = std::sqrt(grain.pan);
+			// Apply envelope (free slots sit at phase 0, where the window is 0)
+			grainSample *= hannWindow4(stream.envPhase[k]);
 
-				leftOut += grainSample * leftGain;
-				rightOut += grainSample * rightGain;
+			// Stolen grains fade out quickly, then free their slot
+			stream.fade[k] -= stream.fadeInc[k] * sampleTime;
+			grainSample *= simd::fmax(stream.fade[k], 0.f);
 
-				// Advance waveform phase at grain frequency (wraps at 1.0)
-				float waveIncrement = grain.frequency * args.sampleTime;
-				grain.wavePhase += waveIncrement;
-			while (grain.wavePhase >= 1.f) grain.wavePhase -= 1.f;
+			// Pan into the grain's two output channels, with the voice's VCA
+			grainSample *= p.vcaGain;
+			mono += grainSample;
+			float_4 outA = grainSample * stream.gainA[k];
+			float_4 outB = grainSample * stream.gainB[k];
+			for (int l = 0; l < 4; l++) {
+				if (!(groupMask & (1u << l))) continue;
+				int g = k * 4 + l;
+				bus[stream.chanA[g]] += outA[l];
+				bus[stream.chanB[g]] += outB[l];
+			}
+
+			// Advance waveform phase at grain frequency (wraps at 1.0)
+			float_4 wavePhase = stream.wavePhase[k] + stream.waveInc[k] * sampleTime;
+			stream.wavePhase[k] = wavePhase - simd::floor(wavePhase);
 
 			// Advance envelope phase based on grain duration
-			float envelopeIncrement = args.sampleTime / grain.duration;
-			grain.envelopePhase += envelopeIncrement;
+			stream.envPhase[k] += stream.envInc[k] * sampleTime;
 
-				// Check if grain is finished based on envelope
-				if (grain.envelopePhase >= 1.f) {
-					grain.reset();
+			// Free grains whose envelope or steal fade has finished
+			int ended = simd::movemask(stream.envPhase[k] >= 1.f) | simd::movemask(stream.fade[k] <= 0.f);
+			if (ended) {
+				for (int l = 0; l < 4; l++) {
+					if (!(ended & (1 << l))) continue;
+					stream.envPhase[k][l] = 0.f;
+					stream.envInc[k][l] = 0.f;
+					stream.waveInc[k][l] = 0.f;
+					stream.fade[k][l] = 1.f;
+					stream.fadeInc[k][l] = 0.f;
 				}
+				stream.activeMask &= ~((uint32_t)ended << (k * 4));
 			}
 		}
 
-		// Output with intelligent gain scaling based on active grain count
-		// More grains = lower gain to prevent clipping
-		// Fewer grains = higher gain to maintain presence
-		float gain = 1.0f;
-		if (activeGrainCount > 0) {
-			// Scale from 1.0 (1 grain) to 0.15 (100+ grains) using logarithmic curve
-			gain = clamp(1.0f / std::sqrt((float)activeGrainCount * 0.5f), 0.15f, 1.0f);
+		stream.monoOut += mono[0] + mono[1] + mono[2] + mono[3];
+
+		return activeGrainCount;
+	}
+
+	void process(const ProcessArgs& args) override {
+		// Lets the loader thread tell when a replaced sample is out of use
+		processTicks.store(processTicks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+		int seed = (int)std::round(params[SEED_PARAM].getValue());
+		if (seed != appliedSeed) {
+			reseedStreams(seed);
 		}
 
-		// Apply VCA gain to final output
-		gain *= vcaGain;
+		// Record the live input first so grains triggered this sample can
+		// start right behind the write head
+		if (sourceMode == SOURCE_LIVE) {
+			liveRing[liveFrames & (LIVE_BUFFER_FRAMES - 1)] = inputs[INAUDIO_INPUT].getVoltage() / 5.f;
+			liveFrames++;
+		}
 
-		outputs[OUTLEFT_OUTPUT].setVoltage(clamp(leftOut * gain, -10.f, 10.f));
-		outputs[OUTRIGHT_OUTPUT].setVoltage(clamp(rightOut * gain, -10.f, 10.f));
+		if (spatialChannels != activeSpatial || panLaw != activePanLaw) {
+			// Layout changed: grains hold channel indices for the old layout,
+			// so restart the cloud
+			activeSpatial = spatialChannels;
+			activePanLaw = panLaw;
+			if (activeSpatial > 0) buildPanTable(activeSpatial, activePanLaw);
+			for (int s = 0; s < STREAM_POOL; s++) {
+				streams[s].resetGrains();
+			}
+		}
+
+		bool blockWanted = blockRendering.load();
+		if (blockWanted != blockActive) {
+			// Mode switched: start from an empty block so no stale audio leaks out
+			blockActive = blockWanted;
+			blockPos = 0;
+			std::memset(blockLeft, 0, sizeof(blockLeft));
+			std::memset(blockRight, 0, sizeof(blockRight));
+			std::fill(blockOutChannels, blockOutChannels + BLOCK_SIZE, 1);
+			std::fill(blockRightChannels, blockRightChannels + BLOCK_SIZE, 1);
+		}
+
+		engineSampleTime = args.sampleTime;
+
+		// Polyphony follows the V/Oct input
+		int channels = clamp(inputs[INFREQUENCY_INPUT].getChannels(), 1, MAX_CHANNELS);
+
+		if (blockActive) {
+			// Queue this sample's parameters and emit the sample rendered one
+			// block ago. Once the queue is full, render the next block.
+			advanceControls(channels, args.sampleTime);
+			blockChannels[blockPos] = channels;
+			std::copy(controlParams, controlParams + channels, blockParams[blockPos]);
+			int streamOutputs = buildStreamMap(channels, blockParams[blockPos], blockStreamMap[blockPos]);
+			writeOutputs(blockLeft[blockPos], blockRight[blockPos], blockOutChannels[blockPos], blockRightChannels[blockPos]);
+			writeStreamOutputs(blockStreamOut[blockPos], blockStreamOnset[blockPos], blockStreamOutputs[blockPos], args.sampleTime);
+			blockStreamOutputs[blockPos] = streamOutputs;
+			blockPos++;
+			if (blockPos >= BLOCK_SIZE) {
+				blockSampleTime = args.sampleTime;
+				renderBlock();
+				blockPos = 0;
+			}
+			writeTelemetry();
+			return;
+		}
+
+		// Per-sample timing costs two clock reads, so only pay for it when
+		// the time budget or the readout needs it
+		bool measureLoad = (budgetMode == BUDGET_TIME) || showRenderTime;
+		double startTime = measureLoad ? system::getTime() : 0.0;
+
+		advanceControls(channels, args.sampleTime);
+		const GrainParams* voiceParams = controlParams;
+
+		float sub[MAX_OVERSAMPLE][BUS_SIZE] = {};
+		int active[MAX_CHANNELS];
+		for (int o = 0; o < oversample; o++) {
+			for (int c = 0; c < channels; c++) {
+				const GrainParams& p = voiceParams[c];
+
+				// Process this channel's streams
+				active[c] = 0;
+				int first, count;
+				channelStreams(channels, c, p.numStreams, first, count);
+				for (int s = first; s < first + count; s++) {
+					if (o == 0) {
+						streams[s].monoOut = 0.f;
+						streams[s].onsetDur = 0.f;
+					}
+					active[c] += processStream(streams[s], p, args.sampleTime / oversample, voiceBus(sub[o], c));
+				}
+			}
+		}
+		float bus[BUS_SIZE];
+		decimate(sub, oversample, bus);
+
+		float outLeft[MAX_CHANNELS];
+		float outRight[MAX_CHANNELS];
+		int rightChannels;
+		int leftChannels = mixBus(bus, active, channels, outLeft, outRight, rightChannels);
+		writeOutputs(outLeft, outRight, leftChannels, rightChannels);
+
+		if (outputs[OUTSTREAMS_OUTPUT].isConnected() || outputs[OUTONSETS_OUTPUT].isConnected()) {
+			int8_t map[STREAM_POOL];
+			int n = buildStreamMap(channels, voiceParams, map);
+			float streamOut[MAX_STREAM_OUTPUTS];
+			float streamOnset[MAX_STREAM_OUTPUTS];
+			for (int s = 0; s < STREAM_POOL; s++) {
+				if (map[s] < 0) continue;
+				streamOut[map[s]] = streams[s].monoOut / oversample;
+				streamOnset[map[s]] = streams[s].onsetDur;
+			}
+			writeStreamOutputs(streamOut, streamOnset, n, args.sampleTime);
+		}
+
+		if (measureLoad) loadAccum += system::getTime() - startTime;
+		if (++governorCounter >= BLOCK_SIZE) {
+			governorCounter = 0;
+			runGovernor(BLOCK_SIZE * args.sampleTime, loadAccum, measureLoad);
+			loadAccum = 0.0;
+		}
+		writeTelemetry();
 	}
 };
 
 
 struct GsxWidget : ModuleWidget {
+	static std::string budgetLabel(Gsx* module) {
+		switch (module->budgetMode) {
+			case Gsx::BUDGET_GRAINS: return string::f("%d grains", module->budgetGrains);
+			case Gsx::BUDGET_TIME: return string::f("%.0f µs", module->budgetMicros);
+			default: return "Unlimited";
+		}
+	}
+
 	GsxWidget(Gsx* module) {
 		setModule(module);
 		setPanel(createPanel(asset::plugin(pluginInstance, "res/gsx.svg")));
@@ -378,9 +1864,143 @@ struct GsxWidget : ModuleWidget {
 		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(30.48, 102.35)), module, Gsx::INVARIATION_INPUT));
 		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(50.8, 102.35)), module, Gsx::INSPREAD_INPUT));
 		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(10.16, 120.13)), module, Gsx::INVCA_INPUT));
+		addInput(createInputCentered<PJ301MPort>(mm2px(Vec(30.48, 120.13)), module, Gsx::INAUDIO_INPUT));
 
 		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(40.64, 120.13)), module, Gsx::OUTLEFT_OUTPUT));
 		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(50.8, 120.13)), module, Gsx::OUTRIGHT_OUTPUT));
+		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(20.32, 120.13)), module, Gsx::OUTLOAD_OUTPUT));
+		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(20.32, 102.35)), module, Gsx::OUTSTREAMS_OUTPUT));
+		addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(40.64, 102.35)), module, Gsx::OUTONSETS_OUTPUT));
+	}
+
+	void appendContextMenu(Menu* menu) override {
+		Gsx* module = dynamic_cast<Gsx*>(this->module);
+		assert(module);
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createMenuLabel("Source"));
+		static const char* SOURCE_NAMES[] = {"Oscillator", "Sample", "Live input"};
+		for (int mode = Gsx::SOURCE_OSCILLATOR; mode <= Gsx::SOURCE_LIVE; mode++) {
+			menu->addChild(createCheckMenuItem(SOURCE_NAMES[mode], "",
+				[=]() { return module->sourceMode == mode; },
+				[=]() { module->setSourceMode(mode); }
+			));
+		}
+		menu->addChild(createMenuItem("Load WAV...", "",
+			[=]() { module->loadSampleDialog(); }
+		));
+		if (!module->samplePath.empty()) {
+			bool ready = module->sampleBuffer.load() != nullptr;
+			menu->addChild(createMenuLabel(system::getFilename(module->samplePath) + (ready ? "" : " (loading)")));
+		}
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createMenuLabel("Output"));
+		static const int SPATIAL_LAYOUTS[] = {0, 4, 8, 16};
+		menu->addChild(createIndexSubmenuItem("Layout",
+			{"Stereo", "4 channels (Left)", "8 channels (Left)", "16 channels (Left)"},
+			[=]() -> size_t {
+				for (int i = 0; i < 4; i++) {
+					if (SPATIAL_LAYOUTS[i] == module->spatialChannels) return i;
+				}
+				return 0;
+			},
+			[=](size_t i) { module->spatialChannels = SPATIAL_LAYOUTS[i]; }
+		));
+		if (module->spatialChannels > 0) {
+			menu->addChild(createIndexPtrSubmenuItem("Panning law", {"Equal-power ring", "VBAP"},
+				&module->panLaw));
+		}
+		else {
+			menu->addChild(createBoolPtrMenuItem("Mix polyphony to stereo", "", &module->mixToStereo));
+		}
+
+		menu->addChild(createBoolPtrMenuItem("Onsets as grain-length gates", "", &module->onsetGates));
+
+		static const int OVERSAMPLE_LIMITS[] = {1, 2, 4};
+		menu->addChild(createIndexSubmenuItem("Anti-aliasing",
+			{"Off", "Up to 2x oversampling", "Up to 4x oversampling"},
+			[=]() -> size_t { return module->oversampleLimit == 4 ? 2 : module->oversampleLimit == 2 ? 1 : 0; },
+			[=](size_t i) { module->oversampleLimit = OVERSAMPLE_LIMITS[i]; }
+		));
+		if (module->oversampleLimit > 1) {
+			menu->addChild(createMenuLabel(module->oversample > 1
+				? string::f("Oversampling now: %dx", module->oversample)
+				: std::string("Oversampling now: not needed")));
+		}
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createMenuLabel("Performance"));
+
+		menu->addChild(createSubmenuItem("CPU budget", budgetLabel(module), [=](Menu* menu) {
+			menu->addChild(createCheckMenuItem("Unlimited", "",
+				[=]() { return module->budgetMode == Gsx::BUDGET_OFF; },
+				[=]() { module->budgetMode = Gsx::BUDGET_OFF; }
+			));
+			menu->addChild(new MenuSeparator);
+			menu->addChild(createMenuLabel("Grains"));
+			static const int GRAIN_BUDGETS[] = {32, 64, 128, 256};
+			for (int grains : GRAIN_BUDGETS) {
+				menu->addChild(createCheckMenuItem(string::f("%d grains", grains), "",
+					[=]() { return module->budgetMode == Gsx::BUDGET_GRAINS && module->budgetGrains == grains; },
+					[=]() { module->budgetMode = Gsx::BUDGET_GRAINS; module->budgetGrains = grains; }
+				));
+			}
+			menu->addChild(new MenuSeparator);
+			menu->addChild(createMenuLabel("Render time per 64 samples"));
+			static const float TIME_BUDGETS[] = {50.f, 100.f, 200.f, 400.f};
+			for (float micros : TIME_BUDGETS) {
+				menu->addChild(createCheckMenuItem(string::f("%.0f µs", micros), "",
+					[=]() { return module->budgetMode == Gsx::BUDGET_TIME && module->budgetMicros == micros; },
+					[=]() { module->budgetMode = Gsx::BUDGET_TIME; module->budgetMicros = micros; }
+				));
+			}
+		}));
+		menu->addChild(createIndexPtrSubmenuItem("Steal", {"Oldest grains", "Quietest grains"},
+			&module->stealPolicy));
+
+		static const int CONTROL_INTERVALS[] = {1, 8, 32, 64};
+		menu->addChild(createSubmenuItem("Control rate",
+			module->controlInterval == 1 ? std::string("Every sample") : string::f("Every %d samples", module->controlInterval),
+			[=](Menu* menu) {
+				for (int interval : CONTROL_INTERVALS) {
+					menu->addChild(createCheckMenuItem(
+						interval == 1 ? std::string("Every sample") : string::f("Every %d samples", interval), "",
+						[=]() { return module->controlInterval == interval; },
+						[=]() { module->controlInterval = interval; }
+					));
+				}
+			}
+		));
+		menu->addChild(createBoolPtrMenuItem("Measure render time", "", &module->showRenderTime));
+
+		menu->addChild(createMenuLabel(string::f("Active grains: %d (cap %d)",
+			module->lastActiveGrains, module->grainCap)));
+		menu->addChild(createMenuLabel(string::f("Steals/sec: %.0f", module->stealRate)));
+		if (module->loadMeasured) {
+			menu->addChild(createMenuLabel(string::f("Render time: %.0f µs / 64 samples", module->renderMicros)));
+		}
+
+		int threads = Gsx::workerCountForMachine() + 1;
+		menu->addChild(createCheckMenuItem("Block rendering (64-sample latency)",
+			string::f("%d thread%s", threads, threads == 1 ? "" : "s"),
+			[=]() { return module->blockRendering.load(); },
+			[=]() { module->setBlockRendering(!module->blockRendering.load()); }
+		));
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createMenuLabel("Seed (0 = random every run)"));
+		// Slider bound to the Seed param (no panel space for a knob)
+		ui::Slider* seedSlider = new ui::Slider;
+		seedSlider->quantity = module->paramQuantities[Gsx::SEED_PARAM];
+		seedSlider->box.size.x = 200.f;
+		menu->addChild(seedSlider);
+		menu->addChild(createMenuItem("New fixed seed", "",
+			[=]() { module->params[Gsx::SEED_PARAM].setValue((float)(1 + random::u32() % 9999)); }
+		));
+		menu->addChild(createMenuItem("Restart cloud", "",
+			[=]() { module->appliedSeed = -1; }
+		));
 	}
 };
 
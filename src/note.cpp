@@ -1,4 +1,6 @@
 #include "plugin.hpp"
+#include "tuning.hpp"
+#include "clock-arbiter.hpp"
 #include <cmath>
 
 
@@ -10,53 +12,9 @@ static const int N_REPEATS  = 8;
 
 
 // --- Scale definitions ---
-// Each scale lists semitones above the root for each row index. Harmonic
-// series uses just-intonation log2(n)*12 for harmonic n=1..12.
-struct ScaleDef {
-	const char* name;
-	int size;
-	float semitones[16];
-};
-
-static const ScaleDef SCALES[] = {
-	{"Chromatic", 12, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}},
-	{"Major",     7,  {0, 2, 4, 5, 7, 9, 11}},
-	{"Minor",     7,  {0, 2, 3, 5, 7, 8, 10}},
-	{"Penta+",    5,  {0, 2, 4, 7, 9}},
-	{"Penta-",    5,  {0, 3, 5, 7, 10}},
-	{"Blues",     6,  {0, 3, 5, 6, 7, 10}},
-	{"Whole",     6,  {0, 2, 4, 6, 8, 10}},
-	{"Harmonic", 12, {
-		0.f,
-		12.f,
-		19.0196f,
-		24.f,
-		27.8631f,
-		31.0196f,
-		33.6883f,
-		36.f,
-		38.0392f,
-		39.8632f,
-		41.5126f,
-		43.0196f
-	}},
-	// --- Modes ---
-	{"Dorian",    7, {0, 2, 3, 5, 7, 9, 10}},
-	{"Phrygian",  7, {0, 1, 3, 5, 7, 8, 10}},
-	{"Lydian",    7, {0, 2, 4, 6, 7, 9, 11}},
-	{"Mixolyd",   7, {0, 2, 4, 5, 7, 9, 10}},
-	// --- Western exotic ---
-	{"HarmMin",   7, {0, 2, 3, 5, 7, 8, 11}},
-	// --- World ---
-	{"Hijaz",     7, {0, 1, 4, 5, 7, 8, 10}},
-	{"Hirajoshi", 5, {0, 2, 3, 7, 8}},
-	// Pelog: non-12-TET approximation of a Surakarta-style tuning so it's
-	// distinct from Phrygian. Cents: 0, 120, 270, 540, 700, 800, 1040.
-	{"Pelog",     7, {0.f, 1.2f, 2.7f, 5.4f, 7.0f, 8.0f, 10.4f}},
-	// Slendro: 5 equal divisions of the octave (non-12-TET, ~2.4 semis each).
-	{"Slendro",   5, {0.f, 2.4f, 4.8f, 7.2f, 9.6f}},
-};
-static const int NUM_SCALES = sizeof(SCALES) / sizeof(SCALES[0]);
+// Shared with Fugue (tuning.hpp); Note offers the list up to Slendro. A loaded
+// Scala tuning can stand in for the selected scale.
+static const int NUM_SCALES = NUM_NOTE_SCALES;
 
 static const char* NOTE_NAMES[12] = {
 	"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
@@ -176,18 +134,20 @@ struct Note : Module {
 	int scaleIndex = 0;        // 0..NUM_SCALES-1
 	int octaveShift = 0;       // -2..+2
 
+	// Scala tuning; while in use it replaces the selected scale
+	TuningLoader scalaTuning;
+	TuningRef scalaRef;          // refreshed by process(); the display reads scalaRef.current
+	bool useScalaTuning = false;
+
 	float currentVelocity = 1.f;
 	float currentVoct = 0.f;
 	bool advanceOnBarOnly = true;
 
-	dsp::SchmittTrigger clockTrigger, barTrigger, resetTrigger;
+	dsp::SchmittTrigger resetTrigger;
 	dsp::PulseGenerator gatePulse, accentPulse;
 
-	// Bar/clock coincidence handling (mirrors Beat)
-	int pendingClockSamples = -1;
-	int barSuppressionSamples = 0;
-	static const int CLOCK_DEFER_SAMPLES = 24;
-	static const int BAR_SUPPRESS_SAMPLES = 96;
+	// Bar/clock coincidence handling (shared with Beat)
+	ClockArbiter arbiter;
 
 	struct OctaveQuantity : ParamQuantity {
 		std::string getDisplayValueString() override {
@@ -202,16 +162,8 @@ struct Note : Module {
 		configSwitch(ROOT_PARAM, 0.f, 11.f, 0.f, "Root note", {
 			"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
 		});
-		configSwitch(SCALE_PARAM, 0.f, (float)(NUM_SCALES - 1), 0.f, "Scale", {
-			"Chromatic", "Major", "Minor",
-			"Pentatonic Major", "Pentatonic Minor",
-			"Blues", "Whole tone", "Harmonic series",
-			"Dorian", "Phrygian", "Lydian", "Mixolydian",
-			"Harmonic Minor", "Hijaz (Arabic)",
-			"Hirajoshi (Japanese)",
-			"Pelog (Gamelan, 7-tone)",
-			"Slendro (Gamelan, 5-equal)"
-		});
+		configSwitch(SCALE_PARAM, 0.f, (float)(NUM_SCALES - 1), 0.f, "Scale",
+			builtinScaleLabels(NUM_SCALES));
 		configParam<OctaveQuantity>(OCT_PARAM, -4.f, 4.f, 0.f, "Octave shift");
 		paramQuantities[OCT_PARAM]->snapEnabled = true;
 		configInput(CLOCK_INPUT, "Clock (step advance)");
@@ -244,8 +196,6 @@ struct Note : Module {
 		currentVelocity = 1.f;
 		currentVoct = 0.f;
 		advanceOnBarOnly = true;
-		pendingClockSamples = -1;
-		barSuppressionSamples = 0;
 		params[ROOT_PARAM].setValue(0.f);
 		params[SCALE_PARAM].setValue(0.f);
 		params[OCT_PARAM].setValue(0.f);
@@ -264,16 +214,26 @@ struct Note : Module {
 		return from;
 	}
 
-	int currentScaleSize() const { return SCALES[scaleIndex].size; }
+	const Tuning& activeTuning() const {
+		const Tuning* scala = scalaRef.current.load();
+		if (useScalaTuning && scala) return *scala;
+		return builtinTuning(scaleIndex);
+	}
+
+	// Larger Scala tunings keep their lowest degrees that fit the matrix
+	int currentScaleSize() const { return std::min(activeTuning().size, N_ROWS - 1); }
 	// Number of selectable rows per scale = scale size + 1 (extra octave row at top)
-	int currentRowCount() const { return SCALES[scaleIndex].size + 1; }
+	int currentRowCount() const { return currentScaleSize() + 1; }
 
 	// V/oct (relative to C0=0) for a given matrix row in the current scale.
-	// The extra "octave" row (row == scaleSize) returns root + 12 semis.
+	// The extra "octave" row (row == scaleSize) returns root + one period
+	// (12 semis unless a Scala tuning says otherwise).
 	float voctForRow(int row) const {
+		const Tuning& tuning = activeTuning();
 		int sz = currentScaleSize();
 		if (row < 0 || row > sz) return 0.f;
-		float semis = (row == sz) ? 12.f : SCALES[scaleIndex].semitones[row];
+		float semis = (row == sz) ? tuning.period : tuning.semitones(row);
+		semis += tuning.offset;
 		semis += (float)rootNote;
 		semis += (float)octaveShift * 12.f;
 		return semis / 12.f;
@@ -299,11 +259,12 @@ struct Note : Module {
 		// Park before step 0; the next CLOCK or BAR pulse will fire it.
 		// Also clear any deferred clock so we don't double-fire.
 		firstClockPending = true;
-		pendingClockSamples = -1;
-		barSuppressionSamples = 0;
+		arbiter.reset();
 	}
 
 	void process(const ProcessArgs& args) override {
+		scalaRef.refresh(scalaTuning);
+
 		// ROOT, SCALE, OCT come from trimpots, optionally summed with CV.
 		int rootK = (int)std::round(params[ROOT_PARAM].getValue());
 		int scaleK = (int)std::round(params[SCALE_PARAM].getValue());
@@ -364,34 +325,11 @@ struct Note : Module {
 			}
 		};
 
-		bool barFired = barConnected
-			&& barTrigger.process(inputs[BAR_INPUT].getVoltage(), 0.1f, 1.f);
-		if (barFired) {
-			pendingClockSamples = -1;
-			barSuppressionSamples = BAR_SUPPRESS_SAMPLES;
-			advanceBar();
-		}
-
-		bool clockFired = clockTrigger.process(inputs[CLOCK_INPUT].getVoltage(), 0.1f, 1.f);
-		if (clockFired && !barFired) {
-			if (barConnected) {
-				if (barSuppressionSamples > 0) {
-					// CLOCK in post-BAR window — same musical event, drop
-				} else {
-					pendingClockSamples = CLOCK_DEFER_SAMPLES;
-				}
-			} else {
-				advanceStep();
-			}
-		}
-		if (pendingClockSamples > 0) {
-			pendingClockSamples--;
-			if (pendingClockSamples == 0) {
-				advanceStep();
-				pendingClockSamples = -1;
-			}
-		}
-		if (barSuppressionSamples > 0) barSuppressionSamples--;
+		ClockArbiter::Events edges = arbiter.process(
+			inputs[CLOCK_INPUT].getVoltage(), inputs[BAR_INPUT].getVoltage(),
+			barConnected, args.sampleTime);
+		if (edges.bar) advanceBar();
+		if (edges.clock) advanceStep();
 
 		bool gateHi = gatePulse.process(args.sampleTime);
 		bool accHi  = accentPulse.process(args.sampleTime);
@@ -417,6 +355,12 @@ struct Note : Module {
 		json_object_set_new(root, "scaleIndex", json_integer(scaleIndex));
 		json_object_set_new(root, "octaveShift", json_integer(octaveShift));
 		json_object_set_new(root, "advanceOnBarOnly", json_boolean(advanceOnBarOnly));
+		if (!scalaTuning.sclPath.empty()) {
+			json_object_set_new(root, "sclPath", json_string(scalaTuning.sclPath.c_str()));
+			if (!scalaTuning.kbmPath.empty())
+				json_object_set_new(root, "kbmPath", json_string(scalaTuning.kbmPath.c_str()));
+		}
+		json_object_set_new(root, "useScalaTuning", json_boolean(useScalaTuning));
 
 		json_t* patArray = json_array();
 		for (int p = 0; p < N_PATTERNS; p++) {
@@ -463,6 +407,12 @@ struct Note : Module {
 			octaveShift = clamp((int)json_integer_value(j), -4, 4);
 		if (json_t* j = json_object_get(root, "advanceOnBarOnly"))
 			advanceOnBarOnly = json_boolean_value(j);
+		if (json_t* j = json_object_get(root, "sclPath")) {
+			json_t* kbmJ = json_object_get(root, "kbmPath");
+			scalaTuning.load(json_string_value(j), kbmJ ? json_string_value(kbmJ) : "");
+		}
+		if (json_t* j = json_object_get(root, "useScalaTuning"))
+			useScalaTuning = json_boolean_value(j);
 
 		json_t* patArray = json_object_get(root, "patterns");
 		if (patArray && json_is_array(patArray)) {
@@ -1042,9 +992,12 @@ void NoteDisplay::drawLayer(const DrawArgs& args, int layer) {
 	}
 	{
 		const rack::math::Rect* statRects[3] = { &rootRect, &scaleRect, &octRect };
+		const Tuning& tuning = module->activeTuning();
 		std::string statValues[3] = {
 			std::string(NOTE_NAMES[module->rootNote]),
-			std::string(SCALES[module->scaleIndex].name),
+			tuning.builtinIndex < 0
+				? tuning.name.substr(0, 9)
+				: std::string(BUILTIN_SCALES[tuning.builtinIndex].shortName),
 			string::f("%+d", module->octaveShift)
 		};
 		for (int i = 0; i < 3; i++) {
@@ -1205,6 +1158,13 @@ struct NoteWidget : ModuleWidget {
 			mm2px(Vec(44.03f, 121.92f)), module, Note::VOCT_OUTPUT));
 	}
 
+	void step() override {
+		ModuleWidget::step();
+		// Free Scala tunings the audio thread has let go of
+		Note* m = dynamic_cast<Note*>(this->module);
+		if (m) m->scalaTuning.pruneRetired();
+	}
+
 	void appendContextMenu(Menu* menu) override {
 		Note* module = dynamic_cast<Note*>(this->module);
 		assert(module);
@@ -1214,6 +1174,30 @@ struct NoteWidget : ModuleWidget {
 			"Advance only on bar trigger", "",
 			&module->advanceOnBarOnly));
 
+		std::shared_ptr<const Tuning> scala = module->scalaTuning.get();
+		menu->addChild(createSubmenuItem("Scala tuning", scala ? scala->name : "",
+			[=](Menu* menu) {
+				menu->addChild(createMenuItem("Load scale (.scl)...", "",
+					[=]() {
+						if (module->scalaTuning.loadDialog(false)) module->useScalaTuning = true;
+					}
+				));
+				menu->addChild(createMenuItem("Load keyboard mapping (.kbm)...", "",
+					[=]() { module->scalaTuning.loadDialog(true); },
+					module->scalaTuning.sclPath.empty()
+				));
+				menu->addChild(createBoolPtrMenuItem("Use instead of SCALE", "",
+					&module->useScalaTuning));
+				menu->addChild(createMenuItem("Clear", "",
+					[=]() {
+						module->scalaTuning.clear();
+						module->useScalaTuning = false;
+					},
+					module->scalaTuning.sclPath.empty()
+				));
+			}
+		));
+
 		menu->addChild(new MenuSeparator);
 		menu->addChild(createMenuLabel("Patterns"));
 		menu->addChild(createMenuItem("Randomize current pattern (notes only)", "",
@@ -0,0 +1,416 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <osdialog.h>
+
+// ─── Built-in Scales ─────────────────────────────────────────────────────────
+// Shared by Fugue and Note so SCALE CV values are interchangeable between the
+// modules. Note offers the first NUM_NOTE_SCALES; Fugue adds the two extras
+// it kept from older versions.
+
+struct ScaleDef {
+	const char* name;        // parameter label
+	const char* shortName;   // fits Note's display
+	int size;
+	float semitones[12];     // above the root
+};
+
+static const ScaleDef BUILTIN_SCALES[] = {
+	{"Chromatic",        "Chromatic", 12, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}},
+	{"Major",            "Major",      7, {0, 2, 4, 5, 7, 9, 11}},
+	{"Minor",            "Minor",      7, {0, 2, 3, 5, 7, 8, 10}},
+	{"Pentatonic Major", "Penta+",     5, {0, 2, 4, 7, 9}},
+	{"Pentatonic Minor", "Penta-",     5, {0, 3, 5, 7, 10}},
+	{"Blues",            "Blues",      6, {0, 3, 5, 6, 7, 10}},
+	{"Whole tone",       "Whole",      6, {0, 2, 4, 6, 8, 10}},
+	// Just-intonation harmonics 1..12 (log2(n)*12)
+	{"Harmonic series",  "Harmonic",  12, {
+		0.f, 12.f, 19.0196f, 24.f, 27.8631f, 31.0196f,
+		33.6883f, 36.f, 38.0392f, 39.8632f, 41.5126f, 43.0196f
+	}},
+	{"Dorian",           "Dorian",     7, {0, 2, 3, 5, 7, 9, 10}},
+	{"Phrygian",         "Phrygian",   7, {0, 1, 3, 5, 7, 8, 10}},
+	{"Lydian",           "Lydian",     7, {0, 2, 4, 6, 7, 9, 11}},
+	{"Mixolydian",       "Mixolyd",    7, {0, 2, 4, 5, 7, 9, 10}},
+	{"Harmonic Minor",   "HarmMin",    7, {0, 2, 3, 5, 7, 8, 11}},
+	{"Hijaz (Arabic)",   "Hijaz",      7, {0, 1, 4, 5, 7, 8, 10}},
+	{"Hirajoshi (Japanese)", "Hirajoshi", 5, {0, 2, 3, 7, 8}},
+	// Pelog: Surakarta-style approximation, distinct from Phrygian.
+	// Cents: 0, 120, 270, 540, 700, 800, 1040.
+	{"Pelog (Gamelan, 7-tone)",    "Pelog",   7, {0.f, 1.2f, 2.7f, 5.4f, 7.0f, 8.0f, 10.4f}},
+	// Slendro: 5 equal divisions of the octave
+	{"Slendro (Gamelan, 5-equal)", "Slendro", 5, {0.f, 2.4f, 4.8f, 7.2f, 9.6f}},
+	// Fugue extras
+	{"Melodic Minor",    "MeloMin",    7, {0, 2, 3, 5, 7, 9, 11}},
+	{"Locrian",          "Locrian",    7, {0, 1, 3, 5, 6, 8, 10}},
+};
+static const int NUM_BUILTIN_SCALES = sizeof(BUILTIN_SCALES) / sizeof(BUILTIN_SCALES[0]);
+static const int NUM_NOTE_SCALES = 17;   // Chromatic .. Slendro
+
+static inline std::vector<std::string> builtinScaleLabels(int count) {
+	std::vector<std::string> labels;
+	for (int i = 0; i < count; i++) labels.push_back(BUILTIN_SCALES[i].name);
+	return labels;
+}
+
+// ─── Tuning ──────────────────────────────────────────────────────────────────
+// A scale compiled for lookup: an ascending degree list that repeats every
+// `period` semitones, plus a bucket table mapping any position within the
+// period to its nearest degree. Index i = octave * size + degree, so both
+// directions are O(1) whether the scale is built in or loaded from Scala.
+
+static const int TUNING_MAX_DEGREES = 128;
+static const int TUNING_BUCKETS = 96;   // 1/8 semitone across a 12-semitone period
+
+struct Tuning {
+	std::string name;
+	int builtinIndex = -1;               // index into BUILTIN_SCALES, -1 when loaded
+	uint32_t serial = 0;                 // unique per compiled tuning, for cache keys
+	int size = 0;
+	float degrees[TUNING_MAX_DEGREES];   // semitones above the root
+	float period = 12.f;                 // semitones between repeats of the degree list
+	float offset = 0.f;                  // semitones, from a .kbm reference pitch
+	uint8_t nearest[TUNING_BUCKETS];
+
+	// Fill the bucket table; call once the degrees and period are set. A
+	// bucket near the top of the period may resolve to index `size`, the
+	// next period's first degree.
+	void compile() {
+		for (int b = 0; b < TUNING_BUCKETS; b++) {
+			float pos = (float)b / TUNING_BUCKETS * period;
+			int best = 0;
+			float bestDiff = 1e9f;
+			for (int d = 0; d <= size; d++) {
+				float degree = (d < size) ? degrees[d] : degrees[0] + period;
+				float diff = std::fabs(degree - pos);
+				if (diff < bestDiff) {
+					bestDiff = diff;
+					best = d;
+				}
+			}
+			nearest[b] = (uint8_t)best;
+		}
+	}
+
+	// Semitones above the root for index = octave * size + degree
+	float semitones(int index) const {
+		int octave = (index >= 0) ? index / size : -((size - 1 - index) / size);
+		return (float)octave * period + degrees[index - octave * size];
+	}
+
+	// Index of the degree nearest `semis` above the root. The bucket gets
+	// within a step of it; degrees closer together than a bucket share one,
+	// so finish by moving to whichever neighbour is nearer.
+	int nearestIndex(float semis) const {
+		int octave = (int)std::floor(semis / period);
+		float pos = semis - (float)octave * period;
+		int b = (int)std::round(pos / period * TUNING_BUCKETS);
+		if (b >= TUNING_BUCKETS) {
+			b = 0;
+			octave++;
+		}
+		int index = octave * size + nearest[std::max(b, 0)];
+		float diff = std::fabs(semitones(index) - semis);
+		while (std::fabs(semitones(index - 1) - semis) < diff) diff = std::fabs(semitones(--index) - semis);
+		while (std::fabs(semitones(index + 1) - semis) < diff) diff = std::fabs(semitones(++index) - semis);
+		return index;
+	}
+};
+
+static inline uint32_t nextTuningSerial() {
+	static std::atomic<uint32_t> counter{1000};   // below 1000: built-in scales
+	return counter++;
+}
+
+static inline const Tuning& builtinTuning(int index) {
+	static std::vector<Tuning> tunings = []() {
+		std::vector<Tuning> result(NUM_BUILTIN_SCALES);
+		for (int i = 0; i < NUM_BUILTIN_SCALES; i++) {
+			Tuning& t = result[i];
+			t.name = BUILTIN_SCALES[i].name;
+			t.builtinIndex = i;
+			t.serial = (uint32_t)i + 1;
+			t.size = BUILTIN_SCALES[i].size;
+			for (int d = 0; d < t.size; d++) t.degrees[d] = BUILTIN_SCALES[i].semitones[d];
+			t.compile();
+		}
+		return result;
+	}();
+	return tunings[std::max(0, std::min(index, NUM_BUILTIN_SCALES - 1))];
+}
+
+// Built-ins live for the whole run, so they're shared without ownership
+static inline std::shared_ptr<const Tuning> builtinTuningPtr(int index) {
+	return std::shared_ptr<const Tuning>(std::shared_ptr<const Tuning>(), &builtinTuning(index));
+}
+
+// ─── Scala Files ─────────────────────────────────────────────────────────────
+// .scl: description, note count, then one pitch per line — cents if it has a
+// period, otherwise a ratio ("3/2" or "2"). The last pitch is the period.
+// .kbm: map size, first/last/middle note, reference note and frequency,
+// formal octave degree, then the mapping ('x' = unmapped key). The mapping
+// picks which degrees the tuning keeps; the reference pitch becomes a fine
+// offset against 12-TET. The middle note is ignored — ROOT sets degree 0.
+
+static const char SCALA_SCL_FILTERS[] = "Scala scale (.scl):scl;All files (*.*):*";
+static const char SCALA_KBM_FILTERS[] = "Scala keyboard mapping (.kbm):kbm;All files (*.*):*";
+
+// Non-comment lines, with '\r' and surrounding whitespace trimmed
+static inline std::vector<std::string> scalaLines(const std::string& text) {
+	std::vector<std::string> lines;
+	std::istringstream stream(text);
+	std::string line;
+	while (std::getline(stream, line)) {
+		if (!line.empty() && line[0] == '!') continue;
+		size_t begin = line.find_first_not_of(" \t\r");
+		size_t end = line.find_last_not_of(" \t\r");
+		lines.push_back(begin == std::string::npos ? "" : line.substr(begin, end - begin + 1));
+	}
+	return lines;
+}
+
+// Pitch line → semitones; false if malformed
+static inline bool parseScalaPitch(const std::string& line, float& semis) {
+	std::string token = line.substr(0, line.find_first_of(" \t"));
+	if (token.empty()) return false;
+	char* end = nullptr;
+	if (token.find('.') != std::string::npos) {
+		semis = std::strtof(token.c_str(), &end) / 100.f;
+		return end != token.c_str();
+	}
+	long num = std::strtol(token.c_str(), &end, 10);
+	long den = 1;
+	if (*end == '/') den = std::strtol(end + 1, &end, 10);
+	if (num <= 0 || den <= 0) return false;
+	semis = 12.f * (float)std::log2((double)num / (double)den);
+	return true;
+}
+
+static inline bool parseScl(const std::string& text, Tuning& out) {
+	std::vector<std::string> lines = scalaLines(text);
+	if (lines.size() < 2) return false;
+	int count = std::atoi(lines[1].c_str());
+	if (count < 1 || (int)lines.size() < 2 + count) return false;
+
+	out.name = lines[0];
+	out.size = 1;
+	out.degrees[0] = 0.f;
+	for (int i = 0; i < count; i++) {
+		float semis;
+		if (!parseScalaPitch(lines[2 + i], semis)) return false;
+		if (i == count - 1) out.period = semis;
+		else if (out.size < TUNING_MAX_DEGREES) out.degrees[out.size++] = semis;
+	}
+	if (out.period <= 0.f) return false;
+	std::sort(out.degrees, out.degrees + out.size);
+	return true;
+}
+
+static inline bool applyKbm(const std::string& text, Tuning& t) {
+	std::vector<std::string> lines = scalaLines(text);
+	if (lines.size() < 7) return false;
+	int mapSize = std::atoi(lines[0].c_str());
+	int referenceNote = std::atoi(lines[4].c_str());
+	float referenceFreq = std::strtof(lines[5].c_str(), nullptr);
+	int octaveDegree = std::atoi(lines[6].c_str());
+	if (mapSize < 0 || referenceFreq <= 0.f) return false;
+
+	t.offset = 12.f * std::log2(referenceFreq / 440.f) - (float)(referenceNote - 69);
+	if (mapSize == 0) return true;
+
+	Tuning source = t;
+	float period = (octaveDegree > 0) ? source.semitones(octaveDegree) : source.period;
+	if (period <= 0.f) return false;
+	t.size = 0;
+	for (int k = 0; k < mapSize && 7 + k < (int)lines.size(); k++) {
+		const std::string& entry = lines[7 + k];
+		if (entry.empty() || entry[0] == 'x') continue;
+		float semis = source.semitones(std::atoi(entry.c_str()));
+		semis -= std::floor(semis / period) * period;
+		if (t.size < TUNING_MAX_DEGREES) t.degrees[t.size++] = semis;
+	}
+	if (t.size == 0) return false;
+	t.period = period;
+	std::sort(t.degrees, t.degrees + t.size);
+	t.size = (int)(std::unique(t.degrees, t.degrees + t.size) - t.degrees);
+	return true;
+}
+
+static inline bool readTextFile(const std::string& path, std::string& text) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+	std::ostringstream ss;
+	ss << file.rdbuf();
+	text = ss.str();
+	return true;
+}
+
+// Parse and compile a .scl (and optional .kbm); nullptr on any error
+static inline Tuning* loadScalaTuning(const std::string& sclPath, const std::string& kbmPath) {
+	std::string text;
+	if (!readTextFile(sclPath, text)) return nullptr;
+	Tuning* t = new Tuning;
+	bool ok = parseScl(text, *t);
+	if (ok && !kbmPath.empty()) ok = readTextFile(kbmPath, text) && applyKbm(text, *t);
+	if (!ok) {
+		delete t;
+		return nullptr;
+	}
+	if (t->name.empty()) t->name = system::getStem(sclPath);
+	t->serial = nextTuningSerial();
+	t->compile();
+	return t;
+}
+
+// ─── Tuning Loader ───────────────────────────────────────────────────────────
+// Parses on one long-lived loader thread and publishes a shared_ptr. The GUI
+// thread hands it a path and returns at once; a newer path supersedes one
+// still parsing. Anything that keeps a tuning beyond one call (quantizers,
+// look-ahead requests) keeps a shared_ptr to it. A replaced tuning goes on
+// the retired list, and is freed only on the GUI thread, by pruneRetired()
+// from the module widget's step(), once the list is its last owner. So the
+// audio and loader threads never free one, and a raw pointer read on the GUI
+// thread stays good for the rest of that call.
+
+struct TuningLoader {
+	std::shared_ptr<const Tuning> tuning;   // through std::atomic_load/exchange only
+	std::atomic<uint32_t> revision{0};      // bumped after each publish
+	std::string sclPath;            // GUI thread
+	std::string kbmPath;
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::string requestScl;                 // guarded by mutex
+	std::string requestKbm;                 // guarded by mutex
+	uint64_t requestGeneration = 0;         // guarded by mutex
+	bool quit = false;                      // guarded by mutex
+	std::vector<std::shared_ptr<const Tuning>> retired;   // guarded by mutex
+
+	~TuningLoader() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		cv.notify_all();
+		if (thread.joinable()) thread.join();
+	}
+
+	// Takes the shared_ptr's lock; the audio thread goes through a TuningRef
+	std::shared_ptr<const Tuning> get() const {
+		return std::atomic_load(&tuning);
+	}
+
+	// With the mutex held
+	void publish(const std::shared_ptr<const Tuning>& t) {
+		std::shared_ptr<const Tuning> old = std::atomic_exchange(&tuning, t);
+		if (old) retired.push_back(old);
+		revision.fetch_add(1, std::memory_order_release);
+	}
+
+	// GUI thread. Cheap enough to call every frame.
+	void pruneRetired() {
+		std::lock_guard<std::mutex> lock(mutex);
+		retired.erase(std::remove_if(retired.begin(), retired.end(),
+			[](const std::shared_ptr<const Tuning>& t) { return t.use_count() == 1; }),
+			retired.end());
+	}
+
+	void load(const std::string& scl, const std::string& kbm) {
+		sclPath = scl;
+		kbmPath = kbm;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			requestScl = scl;
+			requestKbm = kbm;
+			requestGeneration++;
+		}
+		if (!thread.joinable()) {
+			thread = std::thread([this]() { loaderLoop(); });
+		}
+		cv.notify_one();
+	}
+
+	void loaderLoop() {
+		uint64_t seen = 0;
+		while (true) {
+			std::string scl, kbm;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				cv.wait(lock, [&]() { return quit || requestGeneration != seen; });
+				if (quit) return;
+				seen = requestGeneration;
+				scl = requestScl;
+				kbm = requestKbm;
+			}
+			if (scl.empty()) continue;
+			std::shared_ptr<const Tuning> t(loadScalaTuning(scl, kbm));
+			if (!t) continue;
+			std::lock_guard<std::mutex> lock(mutex);
+			// A newer load or a clear() came in while this one parsed
+			if (requestGeneration != seen) continue;
+			publish(t);
+		}
+	}
+
+	// File dialog for the scale or, once a scale is loaded, its keyboard
+	// mapping. Returns true if a load was started.
+	bool loadDialog(bool keyboardMap) {
+		if (keyboardMap && sclPath.empty()) return false;
+		osdialog_filters* filters = osdialog_filters_parse(
+			keyboardMap ? SCALA_KBM_FILTERS : SCALA_SCL_FILTERS);
+		DEFER({ osdialog_filters_free(filters); });
+
+		const std::string& current = keyboardMap ? kbmPath : sclPath;
+		std::string dir = current.empty() ? "" : system::getDirectory(current);
+		char* pathC = osdialog_file(OSDIALOG_OPEN, dir.empty() ? NULL : dir.c_str(), NULL, filters);
+		if (!pathC) return false;
+
+		std::string path = pathC;
+		std::free(pathC);
+		if (keyboardMap) load(sclPath, path);
+		else load(path, kbmPath);
+		return true;
+	}
+
+	// Takes effect at once, and drops any load still parsing
+	void clear() {
+		sclPath.clear();
+		kbmPath.clear();
+		std::lock_guard<std::mutex> lock(mutex);
+		requestGeneration++;
+		publish(nullptr);
+	}
+};
+
+// The audio thread's hold on a loader's tuning. It only goes through the
+// loader's lock when something new has been published, and while it holds a
+// tuning that tuning can't be freed. `current` mirrors it for the GUI thread,
+// and is moved on before the old tuning is let go.
+struct TuningRef {
+	std::shared_ptr<const Tuning> tuning;
+	std::atomic<const Tuning*> current{nullptr};
+	uint32_t revision = 0;
+
+	const std::shared_ptr<const Tuning>& refresh(const TuningLoader& loader) {
+		uint32_t r = loader.revision.load(std::memory_order_acquire);
+		if (r != revision) {
+			std::shared_ptr<const Tuning> next = loader.get();
+			current.store(next.get());
+			tuning = next;
+			revision = r;
+		}
+		return tuning;
+	}
+};